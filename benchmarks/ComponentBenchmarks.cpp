@@ -0,0 +1,361 @@
+#include "../tests/helpers/processor_fixture.h"
+#include "PluginProcessor.h"
+#include "catch2/benchmark/catch_benchmark_all.hpp"
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/reporters/catch_reporter_event_listener.hpp"
+#include "catch2/reporters/catch_reporter_registrars.hpp"
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    constexpr std::array<double, 3> sampleRates { 44100.0, 96000.0, 192000.0 };
+    constexpr std::array<int, 4> blockSizes { 32, 128, 512, 2048 };
+
+    // Automated parameters follow a sine LFO, updated once per block like host automation
+    constexpr double automationRateHz = 2.0;
+
+    //==============================================================================
+    // Each component is wrapped in a small adapter that prepares it for a sample rate
+    // and block size, moves its parameters for automation and processes one block of
+    // stereo noise, either as planar channels or as interleaved frames.
+
+    struct AllpassFilterComponent
+    {
+        static constexpr const char* name = "AllpassFilter";
+        static constexpr bool interleaved = true;
+
+        DSP::Filters::AllpassFilter<float, 2> filter;
+
+        void prepare (double sampleRate, int)
+        {
+            filter.prepare (sampleRate, 100.0);
+            filter.setDelayTime (30.0);
+            filter.setFeedback (0.7f);
+        }
+
+        void automate (float lfo, int blockSize)
+        {
+            filter.setDelayTime (10.0 + 20.0 * lfo, blockSize);
+            filter.setFeedback (0.5f + 0.3f * lfo);
+        }
+
+        void process (float* frames, juce::AudioBuffer<float>&, int numFrames) { filter.processBlock (frames, numFrames); }
+    };
+
+    struct SchroederAllpassChainComponent
+    {
+        static constexpr const char* name = "SchroederAllpassChain";
+        static constexpr bool interleaved = true;
+
+        DSP::Filters::SchroederAllpassChain<float, 2> chain;
+
+        void prepare (double sampleRate, int)
+        {
+            chain.prepare (sampleRate);
+            chain.setDelayTime (30.0f);
+            chain.setCharacter (2.0f);
+        }
+
+        void automate (float lfo, int)
+        {
+            chain.setDelayTime (10.0f + 40.0f * lfo);
+            chain.setCharacter (1.0f + 2.0f * lfo);
+        }
+
+        void process (float* frames, juce::AudioBuffer<float>&, int numFrames) { chain.processBlock (frames, numFrames); }
+    };
+
+    struct BrightnessEQComponent
+    {
+        static constexpr const char* name = "BrightnessEQ";
+        static constexpr bool interleaved = true;
+
+        DSP::Filters::BrightnessEQ<float, 2> eq;
+
+        void prepare (double sampleRate, int blockSize)
+        {
+            eq.prepare ({ sampleRate, (juce::uint32) blockSize, 2 });
+            eq.setBrightness (3.0f);
+        }
+
+        void automate (float lfo, int) { eq.setBrightness (-12.0f + 24.0f * lfo); }
+
+        void process (float* frames, juce::AudioBuffer<float>&, int numFrames) { eq.processFrames (frames, numFrames); }
+    };
+
+    struct DualCutFilterComponent
+    {
+        static constexpr const char* name = "DualCutFilter";
+        static constexpr bool interleaved = true;
+
+        DSP::Filters::DualCutFilter<float, 2> filter;
+
+        void prepare (double sampleRate, int blockSize)
+        {
+            filter.prepare ({ sampleRate, (juce::uint32) blockSize, 2 });
+            filter.setLowCut (20.0f);
+            filter.setHighCut (10.0f);
+        }
+
+        void automate (float lfo, int)
+        {
+            filter.setLowCut (5.0f + 50.0f * lfo);
+            filter.setHighCut (5.0f + 50.0f * (1.0f - lfo));
+        }
+
+        void process (float* frames, juce::AudioBuffer<float>&, int numFrames) { filter.processFrames (frames, numFrames); }
+    };
+
+    struct StereoEnhancerComponent
+    {
+        static constexpr const char* name = "StereoEnhancer";
+        static constexpr bool interleaved = false;
+
+        DSP::Effects::StereoEnhancer<float> enhancer;
+
+        void prepare (double sampleRate, int)
+        {
+            enhancer.prepare (sampleRate);
+            enhancer.setWidth (150.0f);
+            enhancer.setBrightness (3.0f);
+            enhancer.setLowCut (20.0f);
+            enhancer.setHighCut (10.0f);
+        }
+
+        void automate (float lfo, int)
+        {
+            enhancer.setWidth (200.0f * lfo);
+            enhancer.setBrightness (-6.0f + 12.0f * lfo);
+        }
+
+        void process (float*, juce::AudioBuffer<float>& buffer, int numSamples)
+        {
+            enhancer.processBlock (buffer.getWritePointer (0), buffer.getWritePointer (1), numSamples);
+        }
+    };
+
+    struct SmoothLimiterComponent
+    {
+        static constexpr const char* name = "SmoothLimiter";
+        static constexpr bool interleaved = false;
+
+        DSP::Effects::SmoothLimiter<float> limiter;
+
+        void prepare (double sampleRate, int blockSize)
+        {
+            limiter.prepare ({ sampleRate, (juce::uint32) blockSize, 2 });
+            limiter.setEnabled (true);
+            limiter.setCeiling (-6.0f);
+        }
+
+        void automate (float lfo, int) { limiter.setCeiling (-12.0f + 12.0f * lfo); }
+
+        void process (float*, juce::AudioBuffer<float>& buffer, int) { limiter.processBlock (buffer); }
+    };
+
+    struct LookaheadLimiterComponent
+    {
+        static constexpr const char* name = "LookaheadLimiter";
+        static constexpr bool interleaved = false;
+
+        DSP::Effects::LookaheadLimiter<float> limiter;
+
+        void prepare (double sampleRate, int blockSize)
+        {
+            limiter.prepare ({ sampleRate, (juce::uint32) blockSize, 2 });
+            limiter.setEnabled (true);
+            limiter.setCeiling (-6.0f);
+        }
+
+        void automate (float lfo, int) { limiter.setCeiling (-12.0f + 12.0f * lfo); }
+
+        void process (float*, juce::AudioBuffer<float>& buffer, int numSamples)
+        {
+            limiter.process (buffer.getArrayOfWritePointers(), 2, numSamples);
+        }
+    };
+
+    struct BrickWallLimiterComponent
+    {
+        static constexpr const char* name = "BrickWallLimiter";
+        static constexpr bool interleaved = false;
+
+        DSP::Effects::BrickWallLimiter<float> limiter;
+
+        void prepare (double, int) { limiter.setCeiling (0.5f); }
+
+        void automate (float lfo, int) { limiter.setCeiling (0.1f + 0.9f * lfo); }
+
+        void process (float*, juce::AudioBuffer<float>& buffer, int) { limiter.processBlock (buffer); }
+    };
+
+    struct SoftClipperComponent
+    {
+        static constexpr const char* name = "OversampledSoftClipper";
+        static constexpr bool interleaved = false;
+
+        DSP::Effects::OversampledSoftClipper<float> clipper;
+
+        void prepare (double sampleRate, int blockSize)
+        {
+            clipper.prepare ({ sampleRate, (juce::uint32) blockSize, 2 });
+            clipper.setEnabled (true);
+        }
+
+        // The clipper has no continuous parameters, so automation toggles it now and then
+        void automate (float lfo, int) { clipper.setEnabled (lfo > 0.05f); }
+
+        void process (float*, juce::AudioBuffer<float>& buffer, int numSamples)
+        {
+            clipper.process (buffer.getArrayOfWritePointers(), 2, numSamples);
+        }
+    };
+
+    struct ParameterSmootherComponent
+    {
+        static constexpr const char* name = "ParameterSmoother";
+        static constexpr bool interleaved = false;
+
+        DSP::Utils::ParameterSmoother<float> smoother;
+        float target = 1.0f;
+
+        void prepare (double sampleRate, int)
+        {
+            smoother.prepare (sampleRate, 20.0);
+            smoother.reset (target);
+        }
+
+        void automate (float lfo, int) { target = lfo; }
+
+        // One smoothed value per sample, written over the left channel
+        void process (float*, juce::AudioBuffer<float>& buffer, int numSamples)
+        {
+            smoother.processBlock (buffer.getWritePointer (0), numSamples, target);
+        }
+    };
+
+    //==============================================================================
+    // Samples per measured run and sample rate of every component benchmark, by name,
+    // so ThroughputListener can turn Catch's estimate of a run into ns per sample
+    std::map<std::string, std::pair<int, double>> benchmarkSizes;
+
+    template <typename Component>
+    std::string getBenchmarkName (double sampleRate, int blockSize, bool automated)
+    {
+        return std::string (Component::name) + " " + std::to_string (juce::roundToInt (sampleRate)) + " Hz, "
+             + std::to_string (blockSize) + (automated ? " samples, automated" : " samples, static");
+    }
+
+    /** Benchmarks one stereo block at a time through a freshly prepared component.
+        Each run starts from a copy of the noise, so the timings include a small memcpy
+        but never feed the output back in. */
+    template <typename Component>
+    void benchmarkBlock (double sampleRate, int blockSize, bool automated)
+    {
+        Component component;
+        component.prepare (sampleRate, blockSize);
+
+        const auto numSamples = static_cast<size_t> (blockSize);
+
+        juce::AudioBuffer<float> noise (2, blockSize);
+        juce::AudioBuffer<float> buffer (2, blockSize);
+        std::vector<float> noiseFrames (2 * numSamples);
+        std::vector<float> frames (2 * numSamples);
+        juce::Random random (42);
+        ProcessorFixture::fillWithNoise (noise, random, 0.5f);
+
+        for (size_t i = 0; i < numSamples; ++i)
+            for (int channel = 0; channel < 2; ++channel)
+                noiseFrames[2 * i + static_cast<size_t> (channel)] = noise.getSample (channel, static_cast<int> (i));
+
+        auto name = getBenchmarkName<Component> (sampleRate, blockSize, automated);
+        benchmarkSizes[name] = { blockSize, sampleRate };
+        int block = 0;
+
+        BENCHMARK_ADVANCED (std::move (name))
+        (Catch::Benchmark::Chronometer meter)
+        {
+            meter.measure ([&] {
+                if (automated)
+                {
+                    const auto time = static_cast<double> (block++) * blockSize / sampleRate;
+                    const auto lfo = 0.5 + 0.5 * std::sin (juce::MathConstants<double>::twoPi * automationRateHz * time);
+                    component.automate (static_cast<float> (lfo), blockSize);
+                }
+
+                if constexpr (Component::interleaved)
+                {
+                    std::memcpy (frames.data(), noiseFrames.data(), frames.size() * sizeof (float));
+                }
+                else
+                {
+                    for (int channel = 0; channel < 2; ++channel)
+                        std::memcpy (buffer.getWritePointer (channel), noise.getReadPointer (channel), numSamples * sizeof (float));
+                }
+
+                component.process (frames.data(), buffer, blockSize);
+                return buffer.getSample (0, 0) + frames[0];
+            });
+        };
+    }
+
+    /** Benchmarks a component for every sample rate, block size and static or
+        automated parameters. */
+    template <typename Component>
+    void benchmarkComponent()
+    {
+        for (auto sampleRate : sampleRates)
+        {
+            for (auto blockSize : blockSizes)
+            {
+                benchmarkBlock<Component> (sampleRate, blockSize, false);
+                benchmarkBlock<Component> (sampleRate, blockSize, true);
+            }
+        }
+    }
+
+    /** Prints ns per stereo sample and the realtime factor of each component benchmark,
+        derived from the mean Catch estimates for one block. */
+    class ThroughputListener : public Catch::EventListenerBase
+    {
+    public:
+        using Catch::EventListenerBase::EventListenerBase;
+
+        void benchmarkEnded (const Catch::BenchmarkStats<>& stats) override
+        {
+            const auto found = benchmarkSizes.find (stats.info.name);
+
+            if (found == benchmarkSizes.end())
+                return;
+
+            const auto [blockSize, sampleRate] = found->second;
+            const auto nanosecondsPerSample = stats.mean.point.count() / blockSize;
+
+            std::cout << stats.info.name << ": " << nanosecondsPerSample << " ns per sample, "
+                      << 1.0e9 / (nanosecondsPerSample * sampleRate) << "x realtime\n";
+        }
+    };
+}
+
+CATCH_REGISTER_LISTENER (ThroughputListener)
+
+TEST_CASE ("Component throughput", "[components]")
+{
+    SECTION ("AllpassFilter") { benchmarkComponent<AllpassFilterComponent>(); }
+    SECTION ("SchroederAllpassChain") { benchmarkComponent<SchroederAllpassChainComponent>(); }
+    SECTION ("BrightnessEQ") { benchmarkComponent<BrightnessEQComponent>(); }
+    SECTION ("DualCutFilter") { benchmarkComponent<DualCutFilterComponent>(); }
+    SECTION ("StereoEnhancer") { benchmarkComponent<StereoEnhancerComponent>(); }
+    SECTION ("SmoothLimiter") { benchmarkComponent<SmoothLimiterComponent>(); }
+    SECTION ("LookaheadLimiter") { benchmarkComponent<LookaheadLimiterComponent>(); }
+    SECTION ("BrickWallLimiter") { benchmarkComponent<BrickWallLimiterComponent>(); }
+    SECTION ("OversampledSoftClipper") { benchmarkComponent<SoftClipperComponent>(); }
+    SECTION ("ParameterSmoother") { benchmarkComponent<ParameterSmootherComponent>(); }
+}
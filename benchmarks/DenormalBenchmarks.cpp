@@ -0,0 +1,203 @@
+#include "../tests/helpers/processor_fixture.h"
+#include "PluginProcessor.h"
+#include "catch2/catch_test_macros.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    constexpr double decaySampleRate = 48000.0;
+    constexpr int decayBlockSize = 512;
+    constexpr double referenceSeconds = 2.0;
+    constexpr double decaySeconds = 180.0;
+    constexpr double windowSeconds = 10.0;
+
+    // Silence costing more than this many times as much as audio is a decay spike
+    constexpr double maxWindowRatio = 4.0;
+
+    /** Times processStereoBlock on a couple of seconds of noise for reference, then feeds
+        it a unit impulse followed by minutes of silence, timing every block. Nothing here
+        enables flush-to-zero, so any denormals left in a feedback path show up as
+        windows of silence that cost more than the audio did. */
+    template <typename SampleType, typename ProcessFunction>
+    void measureDecay (const char* name, ProcessFunction&& processStereoBlock)
+    {
+        juce::AudioBuffer<SampleType> buffer (2, decayBlockSize);
+        juce::Random random (42);
+
+        const auto numReferenceBlocks = static_cast<int> (referenceSeconds * decaySampleRate) / decayBlockSize;
+        double referenceSum = 0.0;
+
+        for (int block = 0; block < numReferenceBlocks; ++block)
+        {
+            ProcessorFixture::fillWithNoise (buffer, random, 0.2f);
+
+            const auto start = std::chrono::steady_clock::now();
+            processStereoBlock (buffer);
+            const auto end = std::chrono::steady_clock::now();
+
+            referenceSum += std::chrono::duration<double, std::micro> (end - start).count();
+        }
+
+        const auto referenceMean = referenceSum / static_cast<double> (numReferenceBlocks);
+
+        buffer.clear();
+        buffer.setSample (0, 0, SampleType (1));
+        buffer.setSample (1, 0, SampleType (1));
+
+        const auto blocksPerWindow = static_cast<int> (windowSeconds * decaySampleRate) / decayBlockSize;
+        const auto numWindows = static_cast<int> (decaySeconds / windowSeconds);
+        const auto numBlocks = numWindows * blocksPerWindow;
+
+        std::vector<double> blockMicroseconds;
+        blockMicroseconds.reserve (static_cast<size_t> (numBlocks));
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            processStereoBlock (buffer);
+            const auto end = std::chrono::steady_clock::now();
+
+            blockMicroseconds.push_back (std::chrono::duration<double, std::micro> (end - start).count());
+
+            if (block == 0)
+                buffer.clear();
+        }
+
+        std::cout << name << " (us per " << decayBlockSize << " sample block)\n"
+                  << "  noise: mean " << referenceMean << "\n";
+
+        for (int window = 0; window < numWindows; ++window)
+        {
+            const auto first = blockMicroseconds.begin() + window * blocksPerWindow;
+            const auto last = first + blocksPerWindow;
+
+            double sum = 0.0;
+            for (auto it = first; it != last; ++it)
+                sum += *it;
+
+            const auto mean = sum / static_cast<double> (blocksPerWindow);
+            const auto max = *std::max_element (first, last);
+
+            std::cout << "  " << window * windowSeconds << "-" << (window + 1) * windowSeconds
+                      << " s: mean " << mean << ", max " << max << "\n";
+
+            // Allow a microsecond of timer noise for components that cost next to nothing
+            CHECK (mean <= maxWindowRatio * referenceMean + 1.0);
+        }
+    }
+
+    /** Processes a stereo buffer through an interleaved component in control-rate chunks. */
+    template <typename SampleType, typename ProcessFunction>
+    void processInterleaved (juce::AudioBuffer<SampleType>& buffer, std::vector<SampleType>& frames, ProcessFunction&& processFrames)
+    {
+        constexpr int chunkSize = 32;
+        auto* left = buffer.getWritePointer (0);
+        auto* right = buffer.getWritePointer (1);
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            frames[static_cast<size_t> (2 * i)] = left[i];
+            frames[static_cast<size_t> (2 * i + 1)] = right[i];
+        }
+
+        for (int start = 0; start < buffer.getNumSamples(); start += chunkSize)
+            processFrames (frames.data() + 2 * start, std::min (chunkSize, buffer.getNumSamples() - start));
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            left[i] = frames[static_cast<size_t> (2 * i)];
+            right[i] = frames[static_cast<size_t> (2 * i + 1)];
+        }
+    }
+
+    template <typename SampleType>
+    void measureComponentDecay()
+    {
+        const juce::dsp::ProcessSpec spec { decaySampleRate, (juce::uint32) decayBlockSize, 2 };
+        std::vector<SampleType> frames (2 * decayBlockSize);
+
+        SECTION ("Allpass chain")
+        {
+            DSP::Filters::SchroederAllpassChain<SampleType, 2> chain;
+            chain.prepare (decaySampleRate);
+            chain.setDelayTime (SampleType (60));
+            chain.setCharacter (SampleType (10));
+
+            measureDecay<SampleType> ("Allpass chain", [&] (auto& buffer) {
+                processInterleaved (buffer, frames, [&] (SampleType* data, int n) { chain.processBlock (data, n); });
+            });
+        }
+
+        SECTION ("Brightness EQ and cut filters")
+        {
+            DSP::Filters::BrightnessEQ<SampleType, 2> brightnessEQ;
+            DSP::Filters::DualCutFilter<SampleType, 2> dualCutFilter;
+            brightnessEQ.prepare (spec);
+            brightnessEQ.setBrightness (SampleType (6));
+            dualCutFilter.prepare (spec);
+            dualCutFilter.setLowCut (SampleType (30));
+            dualCutFilter.setHighCut (SampleType (30));
+
+            measureDecay<SampleType> ("Brightness EQ and cut filters", [&] (auto& buffer) {
+                processInterleaved (buffer, frames, [&] (SampleType* data, int n) {
+                    brightnessEQ.processFrames (data, n);
+                    dualCutFilter.processFrames (data, n);
+                });
+            });
+        }
+
+        SECTION ("Stereo enhancer")
+        {
+            DSP::Effects::StereoEnhancer<SampleType> enhancer;
+            enhancer.prepare (decaySampleRate);
+            enhancer.setWidth (SampleType (150));
+            enhancer.setBrightness (SampleType (3));
+            enhancer.setLowCut (SampleType (30));
+            enhancer.setHighCut (SampleType (30));
+            enhancer.setMultibandEnabled (true);
+
+            measureDecay<SampleType> ("Stereo enhancer", [&] (auto& buffer) { enhancer.processBlock (buffer); });
+        }
+
+        SECTION ("Limiters")
+        {
+            DSP::Effects::SmoothLimiter<SampleType> smoothLimiter;
+            DSP::Effects::LookaheadLimiter<SampleType> lookaheadLimiter;
+            smoothLimiter.prepare (spec);
+            smoothLimiter.setEnabled (true);
+            lookaheadLimiter.prepare (spec);
+            lookaheadLimiter.setEnabled (true);
+
+            measureDecay<SampleType> ("Smooth and lookahead limiters", [&] (auto& buffer) {
+                smoothLimiter.processBlock (buffer);
+                lookaheadLimiter.process (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples());
+            });
+        }
+
+        SECTION ("DSP processor")
+        {
+            DSP::Core::ChasmDSPProcessor<SampleType> processor;
+            processor.prepare (spec);
+            ProcessorFixture::applySettings (processor, { .mixPercent = 100.0, .delayMs = 60.0, .brightnessDb = 3.0,
+                                                          .character = 10.0, .lowCutPercent = 20.0 });
+
+            measureDecay<SampleType> ("DSP processor", [&] (auto& buffer) { processor.processBlock (buffer); });
+        }
+    }
+}
+
+TEST_CASE ("CPU stays flat while a tail decays into silence")
+{
+    SECTION ("Float")
+    {
+        measureComponentDecay<float>();
+    }
+
+    SECTION ("Double")
+    {
+        measureComponentDecay<double>();
+    }
+}
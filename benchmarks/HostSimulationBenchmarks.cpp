@@ -0,0 +1,231 @@
+#include "../tests/helpers/processor_fixture.h"
+#include "PluginProcessor.h"
+#include "catch2/catch_test_macros.hpp"
+#include "helpers/benchmark_report.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    // Host sessions to simulate, each prepared at its own rate and maximum block size
+    struct HostSession
+    {
+        double sampleRate;
+        int maxBlockSize;
+    };
+
+    constexpr std::array<HostSession, 5> sessions { { { 44100.0, 512 },
+                                                      { 48000.0, 128 },
+                                                      { 48000.0, 1024 },
+                                                      { 96000.0, 256 },
+                                                      { 192000.0, 2048 } } };
+
+    constexpr int blocksPerSession = 20000;
+
+    // How often the host engages bypass, and for how long
+    constexpr int bypassPeriod = 500;
+    constexpr int bypassLength = 20;
+
+    // Histogram bins are powers of two of the real-time budget, from 2^-16 up to 2^3
+    constexpr int minBinExponent = -16;
+    constexpr int maxBinExponent = 3;
+    constexpr int numBins = maxBinExponent - minBinExponent + 2;
+
+    struct SessionResult
+    {
+        const char* precision;
+        HostSession session;
+        int numBlocks;
+        int deadlineMisses;
+        double p50, p99, p999, max;
+        std::array<int, numBins> histogram;
+    };
+
+    /** Block sizes like hosts send them: mostly full blocks, with the rest split at
+        loop points, automation and tempo changes into anything from 1 sample up. */
+    int nextBlockSize (juce::Random& random, int maxBlockSize)
+    {
+        if (random.nextInt (10) < 6)
+            return maxBlockSize;
+
+        return 1 + random.nextInt (maxBlockSize);
+    }
+
+    /** Moves every parameter once per block along its own LFO, switching the bool
+        parameters now and then. Bypass is left to the caller. */
+    void automateParameters (PluginProcessor& plugin, double seconds)
+    {
+        const auto& parameters = plugin.getParameters();
+
+        for (int i = 0; i < parameters.size(); ++i)
+        {
+            auto* parameter = parameters.getUnchecked (i);
+
+            if (auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*> (parameter); withID != nullptr && withID->paramID == "BYPASS")
+                continue;
+
+            const auto rateHz = 0.25 + 0.37 * static_cast<double> (i);
+            const auto lfo = 0.5 + 0.5 * std::sin (juce::MathConstants<double>::twoPi * rateHz * seconds);
+
+            if (parameter->isBoolean())
+                parameter->setValueNotifyingHost (lfo > 0.5 ? 1.0f : 0.0f);
+            else
+                parameter->setValueNotifyingHost (static_cast<float> (lfo));
+        }
+    }
+
+    /** Nearest-rank percentile of sorted values. */
+    double percentile (const std::vector<double>& sorted, double fraction)
+    {
+        const auto rank = static_cast<size_t> (std::ceil (fraction * static_cast<double> (sorted.size())));
+        return sorted[std::clamp<size_t> (rank, 1, sorted.size()) - 1];
+    }
+
+    int binFor (double budgetFraction)
+    {
+        if (budgetFraction <= 0.0)
+            return 0;
+
+        const auto exponent = static_cast<int> (std::ceil (std::log2 (budgetFraction)));
+        return std::clamp (exponent - minBinExponent, 0, numBins - 1);
+    }
+
+    /** Prepares the plugin for one session, the way hosts do after a sample rate or
+        buffer size change, then times every processBlock call against the duration of
+        the audio it was given. Automation, bypass and buffer filling are not timed. */
+    template <typename SampleType>
+    SessionResult runSession (PluginProcessor& plugin, const char* precision, HostSession session, juce::Random& random)
+    {
+        plugin.releaseResources();
+        plugin.prepareToPlay (session.sampleRate, session.maxBlockSize);
+
+        juce::AudioBuffer<SampleType> storage (2, session.maxBlockSize);
+        juce::MidiBuffer midi;
+        auto* bypass = plugin.apvts.getParameter ("BYPASS");
+
+        std::vector<double> budgetFractions;
+        budgetFractions.reserve (blocksPerSession);
+
+        SessionResult result { precision, session, blocksPerSession, 0, 0.0, 0.0, 0.0, 0.0, {} };
+        juce::int64 samplePosition = 0;
+
+        for (int block = 0; block < blocksPerSession; ++block)
+        {
+            automateParameters (plugin, static_cast<double> (samplePosition) / session.sampleRate);
+            bypass->setValueNotifyingHost (block % bypassPeriod < bypassLength ? 1.0f : 0.0f);
+
+            const auto numSamples = nextBlockSize (random, session.maxBlockSize);
+            juce::AudioBuffer<SampleType> buffer (storage.getArrayOfWritePointers(), storage.getNumChannels(), numSamples);
+            ProcessorFixture::fillWithNoise (buffer, random, 0.5f);
+
+            const auto start = std::chrono::steady_clock::now();
+            plugin.processBlock (buffer, midi);
+            const auto end = std::chrono::steady_clock::now();
+
+            const auto budget = static_cast<double> (numSamples) / session.sampleRate;
+            const auto fraction = std::chrono::duration<double> (end - start).count() / budget;
+
+            budgetFractions.push_back (fraction);
+            ++result.histogram[static_cast<size_t> (binFor (fraction))];
+
+            if (fraction >= 1.0)
+                ++result.deadlineMisses;
+
+            samplePosition += numSamples;
+        }
+
+        std::sort (budgetFractions.begin(), budgetFractions.end());
+        result.p50 = percentile (budgetFractions, 0.5);
+        result.p99 = percentile (budgetFractions, 0.99);
+        result.p999 = percentile (budgetFractions, 0.999);
+        result.max = budgetFractions.back();
+
+        return result;
+    }
+
+    void writeReport (const std::vector<SessionResult>& results, std::ostream& stream)
+    {
+        stream << std::setprecision (6) << "{\n  \"benchmark\": \"host_simulation\",\n"
+               << "  \"unit\": \"fraction of real-time budget\",\n  \"sessions\": [\n";
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto& result = results[i];
+
+            stream << "    {\n"
+                   << "      \"precision\": \"" << result.precision << "\",\n"
+                   << "      \"sampleRate\": " << result.session.sampleRate << ",\n"
+                   << "      \"maxBlockSize\": " << result.session.maxBlockSize << ",\n"
+                   << "      \"blocks\": " << result.numBlocks << ",\n"
+                   << "      \"deadlineMisses\": " << result.deadlineMisses << ",\n"
+                   << "      \"p50\": " << result.p50 << ",\n"
+                   << "      \"p99\": " << result.p99 << ",\n"
+                   << "      \"p99.9\": " << result.p999 << ",\n"
+                   << "      \"max\": " << result.max << ",\n"
+                   << "      \"histogram\": [";
+
+            // Each bin counts the blocks up to its bound, the last one everything above
+            for (int bin = 0; bin < numBins; ++bin)
+            {
+                stream << (bin == 0 ? "" : ", ") << "{ \"upTo\": ";
+
+                if (bin == numBins - 1)
+                    stream << "null";
+                else
+                    stream << std::ldexp (1.0, minBinExponent + bin);
+
+                stream << ", \"count\": " << result.histogram[static_cast<size_t> (bin)] << " }";
+            }
+
+            stream << "]\n    }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+
+        stream << "  ]\n}\n";
+    }
+}
+
+TEST_CASE ("Host simulation", "[host]")
+{
+    std::vector<SessionResult> results;
+    juce::Random random (2024);
+
+    // One plugin per precision, moved from session to session like a host changing its settings
+    {
+        PluginProcessor plugin;
+        plugin.setProcessingPrecision (juce::AudioProcessor::singlePrecision);
+
+        for (const auto& session : sessions)
+            results.push_back (runSession<float> (plugin, "float", session, random));
+    }
+
+    {
+        PluginProcessor plugin;
+        plugin.setProcessingPrecision (juce::AudioProcessor::doublePrecision);
+
+        for (const auto& session : sessions)
+            results.push_back (runSession<double> (plugin, "double", session, random));
+    }
+
+    std::cout << "precision     rate  block      p50      p99    p99.9      max  misses\n";
+
+    for (const auto& result : results)
+    {
+        std::cout << std::fixed << std::setprecision (4)
+                  << std::setw (9) << result.precision << std::setw (9) << static_cast<int> (result.session.sampleRate)
+                  << std::setw (7) << result.session.maxBlockSize
+                  << std::setw (9) << result.p50 << std::setw (9) << result.p99
+                  << std::setw (9) << result.p999 << std::setw (9) << result.max
+                  << std::setw (8) << result.deadlineMisses << "\n";
+
+        CHECK (result.p99 < 1.0);
+    }
+
+    auto report = openBenchmarkReport ("CHASM_HOST_SIMULATION_REPORT", "host_simulation.json");
+    writeReport (results, report);
+    CHECK (report.good());
+}
@@ -0,0 +1,206 @@
+#include "../tests/helpers/processor_fixture.h"
+#include "PluginProcessor.h"
+#include "catch2/catch_test_macros.hpp"
+#include "helpers/benchmark_report.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#if JUCE_WINDOWS
+    #include <windows.h>
+    #include <psapi.h>
+#elif JUCE_MAC
+    #include <mach/mach.h>
+#elif JUCE_LINUX
+    #include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr double hostSampleRate = 48000.0;
+    constexpr int hostBlockSize = 512;
+    constexpr int maxInstances = 512;
+
+    // Every instance count processes about this many blocks in total, spread over the instances
+    constexpr int blocksPerMeasurement = 8192;
+    constexpr int minRounds = 8;
+
+    struct ScalingResult
+    {
+        int numInstances;
+        double nanosecondsPerSample;
+        double realtimeInstances;
+        double slowdown;
+        double residentBytesPerInstance;
+        double otherResidentBytesPerInstance;
+    };
+
+    // The memory of one instance that can be counted exactly
+    struct InstanceBytes
+    {
+        size_t object;
+        size_t dspState;
+    };
+
+    /** The resident set size of the whole process, or 0 where it can't be read. */
+    size_t getResidentBytes()
+    {
+       #if JUCE_WINDOWS
+        PROCESS_MEMORY_COUNTERS counters {};
+
+        if (GetProcessMemoryInfo (GetCurrentProcess(), &counters, sizeof (counters)))
+            return counters.WorkingSetSize;
+       #elif JUCE_MAC
+        mach_task_basic_info info {};
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+
+        if (task_info (mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t> (&info), &count) == KERN_SUCCESS)
+            return info.resident_size;
+       #elif JUCE_LINUX
+        std::ifstream statm ("/proc/self/statm");
+        size_t totalPages = 0, residentPages = 0;
+
+        if (statm >> totalPages >> residentPages)
+            return residentPages * static_cast<size_t> (sysconf (_SC_PAGESIZE));
+       #endif
+
+        return 0;
+    }
+
+    /** Runs one block through each instance in turn, the way a host walks its tracks,
+        every instance with its own buffer refilled from the shared input. */
+    void processRound (std::vector<std::unique_ptr<PluginProcessor>>& instances,
+                       std::vector<juce::AudioBuffer<float>>& buffers,
+                       const juce::AudioBuffer<float>& input,
+                       int numInstances)
+    {
+        juce::MidiBuffer midi;
+
+        for (int i = 0; i < numInstances; ++i)
+        {
+            auto& buffer = buffers[static_cast<size_t> (i)];
+
+            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                buffer.copyFrom (channel, 0, input, channel, 0, hostBlockSize);
+
+            instances[static_cast<size_t> (i)]->processBlock (buffer, midi);
+        }
+    }
+
+    void writeReport (const std::vector<ScalingResult>& results, const InstanceBytes& instanceBytes, std::ostream& stream)
+    {
+        stream << std::setprecision (6) << "{\n  \"benchmark\": \"multi_instance\",\n"
+               << "  \"sampleRate\": " << hostSampleRate << ",\n"
+               << "  \"blockSize\": " << hostBlockSize << ",\n"
+               << "  \"objectBytes\": " << instanceBytes.object << ",\n"
+               << "  \"dspStateBytes\": " << instanceBytes.dspState << ",\n  \"instanceCounts\": [\n";
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto& result = results[i];
+
+            stream << "    { \"instances\": " << result.numInstances
+                   << ", \"nsPerSample\": " << result.nanosecondsPerSample
+                   << ", \"realtimeInstances\": " << result.realtimeInstances
+                   << ", \"slowdown\": " << result.slowdown
+                   << ", \"residentBytesPerInstance\": " << result.residentBytesPerInstance
+                   << ", \"otherResidentBytesPerInstance\": " << result.otherResidentBytesPerInstance
+                   << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+
+        stream << "  ]\n}\n";
+    }
+}
+
+/** Grows a session from 1 to 512 instances, doubling each time. At every size it
+    reports the cost per stereo sample of one instance, how many instances would run
+    in real time on this thread, the slowdown against a single instance once the
+    working set outgrows the caches, and the resident memory added per instance.
+    The object and its DSP state are counted exactly. The rest of the resident
+    figure is the parameter tree, the oversampling filters, the preset manager and
+    allocator overhead, which only the RSS can tell. */
+TEST_CASE ("Multi-instance scaling", "[instances]")
+{
+    juce::AudioBuffer<float> input (2, hostBlockSize);
+    juce::Random random (7);
+    ProcessorFixture::fillWithNoise (input, random, 0.5f);
+
+    // The host's own buffers are allocated up front, so they aren't counted against the instances
+    std::vector<juce::AudioBuffer<float>> buffers;
+    buffers.reserve (maxInstances);
+
+    for (int i = 0; i < maxInstances; ++i)
+    {
+        buffers.emplace_back (2, hostBlockSize);
+        buffers.back().clear();
+    }
+
+    std::vector<std::unique_ptr<PluginProcessor>> instances;
+    instances.reserve (maxInstances);
+
+    std::vector<ScalingResult> results;
+    InstanceBytes instanceBytes {};
+    const auto baselineResidentBytes = getResidentBytes();
+
+    for (int numInstances = 1; numInstances <= maxInstances; numInstances *= 2)
+    {
+        while (static_cast<int> (instances.size()) < numInstances)
+        {
+            instances.push_back (std::make_unique<PluginProcessor>());
+            instances.back()->prepareToPlay (hostSampleRate, hostBlockSize);
+        }
+
+        instanceBytes = { sizeof (PluginProcessor), instances.front()->getDSPStateBytes() };
+
+        // One untimed round touches every delay line and filter, so the memory is resident
+        processRound (instances, buffers, input, numInstances);
+
+        const auto residentBytes = getResidentBytes();
+        const auto rounds = std::max (minRounds, blocksPerMeasurement / numInstances);
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int round = 0; round < rounds; ++round)
+            processRound (instances, buffers, input, numInstances);
+
+        const auto seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+
+        const auto samplesProcessed = static_cast<double> (rounds) * numInstances * hostBlockSize;
+        const auto audioSecondsPerInstance = static_cast<double> (rounds) * hostBlockSize / hostSampleRate;
+
+        ScalingResult result;
+        result.numInstances = numInstances;
+        result.nanosecondsPerSample = seconds * 1.0e9 / samplesProcessed;
+        result.realtimeInstances = numInstances * audioSecondsPerInstance / seconds;
+        result.slowdown = results.empty() ? 1.0 : result.nanosecondsPerSample / results.front().nanosecondsPerSample;
+        result.residentBytesPerInstance = residentBytes > baselineResidentBytes
+                                              ? static_cast<double> (residentBytes - baselineResidentBytes) / numInstances
+                                              : 0.0;
+
+        const auto countedBytes = static_cast<double> (instanceBytes.object + instanceBytes.dspState);
+        result.otherResidentBytesPerInstance = std::max (0.0, result.residentBytesPerInstance - countedBytes);
+
+        results.push_back (result);
+    }
+
+    std::cout << "bytes per instance: " << instanceBytes.object << " object + " << instanceBytes.dspState << " DSP state\n"
+              << "instances  ns/sample  realtime instances  slowdown  resident bytes/instance     of which other\n";
+
+    for (const auto& result : results)
+    {
+        std::cout << std::fixed << std::setprecision (2)
+                  << std::setw (9) << result.numInstances << std::setw (11) << result.nanosecondsPerSample
+                  << std::setw (20) << result.realtimeInstances << std::setw (10) << result.slowdown
+                  << std::setw (25) << std::setprecision (0) << result.residentBytesPerInstance
+                  << std::setw (19) << result.otherResidentBytesPerInstance << "\n";
+
+        CHECK (result.realtimeInstances > 1.0);
+    }
+
+    auto report = openBenchmarkReport ("CHASM_MULTI_INSTANCE_REPORT", "multi_instance.json");
+    writeReport (results, instanceBytes, report);
+    CHECK (report.good());
+}
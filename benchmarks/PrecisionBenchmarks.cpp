@@ -0,0 +1,74 @@
+#include "../tests/helpers/processor_fixture.h"
+#include "PluginProcessor.h"
+#include "catch2/benchmark/catch_benchmark_all.hpp"
+#include "catch2/catch_test_macros.hpp"
+
+namespace
+{
+    constexpr double benchmarkSampleRate = 48000.0;
+    constexpr int benchmarkBlockSize = 512;
+
+    template <typename SampleType>
+    juce::AudioBuffer<SampleType> makeNoise()
+    {
+        juce::AudioBuffer<SampleType> noise (2, benchmarkBlockSize);
+        juce::Random random (42);
+        ProcessorFixture::fillWithNoise (noise, random);
+        return noise;
+    }
+
+    template <typename SampleType>
+    void benchmarkDSPProcessor (const char* name)
+    {
+        DSP::Core::ChasmDSPProcessor<SampleType> processor;
+        processor.prepare ({ benchmarkSampleRate, (juce::uint32) benchmarkBlockSize, 2 });
+        ProcessorFixture::applySettings (processor, { .mixPercent = 50.0, .delayMs = 30.0, .brightnessDb = 3.0, .character = 1.5,
+                                                      .lowCutPercent = 20.0, .widthPercent = 120.0 });
+
+        const auto input = makeNoise<SampleType>();
+        juce::AudioBuffer<SampleType> buffer (2, benchmarkBlockSize);
+
+        BENCHMARK (name)
+        {
+            buffer.makeCopyOf (input, true);
+            processor.processBlock (buffer);
+            return buffer.getSample (0, 0);
+        };
+    }
+
+    template <typename SampleType>
+    void benchmarkPlugin (const char* name, juce::AudioProcessor::ProcessingPrecision precision)
+    {
+        PluginProcessor plugin;
+        plugin.setProcessingPrecision (precision);
+        plugin.prepareToPlay (benchmarkSampleRate, benchmarkBlockSize);
+
+        const auto input = makeNoise<SampleType>();
+        juce::AudioBuffer<SampleType> buffer (2, benchmarkBlockSize);
+        juce::MidiBuffer midi;
+
+        BENCHMARK (name)
+        {
+            buffer.makeCopyOf (input, true);
+            plugin.processBlock (buffer, midi);
+            return buffer.getSample (0, 0);
+        };
+
+        plugin.releaseResources();
+    }
+}
+
+TEST_CASE ("Float vs double precision")
+{
+    SECTION ("DSP processor, 512 samples stereo")
+    {
+        benchmarkDSPProcessor<float> ("Float processor");
+        benchmarkDSPProcessor<double> ("Double processor");
+    }
+
+    SECTION ("Plugin processBlock, 512 samples stereo")
+    {
+        benchmarkPlugin<float> ("Float plugin", juce::AudioProcessor::singlePrecision);
+        benchmarkPlugin<double> ("Double plugin", juce::AudioProcessor::doublePrecision);
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstdlib>
+#include <fstream>
+
+/* Opens the file a benchmark writes its JSON report to: the path in the given
+ * environment variable if it is set, otherwise the default path, relative to the
+ * working directory.
+ *
+ * Example usage
+ *
+  auto report = openBenchmarkReport ("CHASM_HOST_SIMULATION_REPORT", "host_simulation.json");
+  writeReport (results, report);
+  CHECK (report.good());
+
+ */
+[[maybe_unused]] static std::ofstream openBenchmarkReport (const char* pathVariable, const char* defaultPath)
+{
+    const auto* path = std::getenv (pathVariable);
+    return std::ofstream (path != nullptr ? path : defaultPath);
+}
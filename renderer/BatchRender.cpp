@@ -0,0 +1,140 @@
+#include "BatchRender.h"
+#include "FileRenderer.h"
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <vector>
+
+namespace Renderer
+{
+    namespace
+    {
+        /** Collects the WAV and AIFF files named on the command line, and those directly
+            inside any folder named there. The first argument is the command itself. */
+        juce::Array<juce::File> findInputFiles (const juce::ArgumentList& args)
+        {
+            juce::Array<juce::File> files;
+
+            for (int i = 1; i < args.size(); ++i)
+            {
+                if (args[i].isOption())
+                    continue;
+
+                const auto file = args[i].resolveAsFile();
+
+                if (file.isDirectory())
+                {
+                    auto folderFiles = file.findChildFiles (juce::File::findFiles, false, "*.wav;*.aif;*.aiff");
+                    folderFiles.sort();
+                    files.addArray (folderFiles);
+                }
+                else if (file.existsAsFile() && file.hasFileExtension ("wav;aif;aiff"))
+                {
+                    files.add (file);
+                }
+                else
+                {
+                    juce::ConsoleApplication::fail (file.getFullPathName() + " is not a WAV or AIFF file or a folder");
+                }
+            }
+
+            if (files.isEmpty())
+                juce::ConsoleApplication::fail ("No WAV or AIFF files to render");
+
+            return files;
+        }
+
+        /** Every file is written to the output folder under its own name, so two inputs
+            with the same name (from different folders, or one named twice) would be
+            rendered over each other. Names are compared ignoring case, as the output
+            folder may be on a case-insensitive file system. */
+        void checkOutputNamesAreUnique (const juce::Array<juce::File>& files)
+        {
+            std::map<juce::String, juce::File> filesByName;
+
+            for (const auto& file : files)
+            {
+                const auto [existing, inserted] = filesByName.emplace (file.getFileName().toLowerCase(), file);
+
+                if (! inserted)
+                    juce::ConsoleApplication::fail (file.getFullPathName() + " and " + existing->second.getFullPathName()
+                                                    + " would both be rendered to " + file.getFileName());
+            }
+        }
+    }
+
+    void runInParallel (int numJobs, int numThreads, const std::function<void (int)>& job)
+    {
+        std::atomic<int> numRemaining { numJobs };
+        juce::WaitableEvent allFinished;
+        juce::ThreadPool pool (juce::jmax (1, juce::jmin (numThreads, numJobs)));
+
+        for (int i = 0; i < numJobs; ++i)
+        {
+            pool.addJob ([&, i]
+            {
+                job (i);
+
+                if (--numRemaining == 0)
+                    allFinished.signal();
+            });
+        }
+
+        if (numJobs > 0)
+            allFinished.wait();
+    }
+
+    void runBatchRender (const juce::ArgumentList& args)
+    {
+        const auto outputFolder = args.getFileForOption ("--output");
+        const auto files = findInputFiles (args);
+        checkOutputNamesAreUnique (files);
+        const auto settings = RenderSettings::fromArguments (args);
+
+        if (const auto created = outputFolder.createDirectory(); created.failed())
+            juce::ConsoleApplication::fail ("Couldn't create " + outputFolder.getFullPathName() + ": " + created.getErrorMessage());
+
+        const auto numThreads = juce::jmin (settings.numThreads, files.size());
+
+        std::cout << "Rendering " << files.size() << " files on " << numThreads << " threads with\n"
+                  << settings.describeParameters() << "\n";
+
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        std::vector<RenderResult> results (static_cast<size_t> (files.size()));
+        juce::CriticalSection printLock;
+
+        const auto start = std::chrono::steady_clock::now();
+
+        runInParallel (files.size(), numThreads, [&] (int i)
+        {
+            auto& result = results[static_cast<size_t> (i)];
+            result = renderFile (files[i], outputFolder.getChildFile (files[i].getFileName()), settings, formats);
+
+            const juce::ScopedLock lock (printLock);
+            printResult (result);
+        });
+
+        const auto seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+        double audioSeconds = 0.0;
+        int numFailed = 0;
+
+        for (const auto& result : results)
+        {
+            if (result.error.isNotEmpty())
+                ++numFailed;
+            else
+                audioSeconds += result.audioSeconds;
+        }
+
+        std::cout << std::fixed << std::setprecision (1)
+                  << "Rendered " << audioSeconds << " s of audio in " << seconds << " s, realtime x"
+                  << (seconds > 0.0 ? audioSeconds / seconds : 0.0) << "\n";
+
+        if (numFailed > 0)
+            juce::ConsoleApplication::fail (juce::String (numFailed) + " of " + juce::String (files.size()) + " files failed");
+    }
+}
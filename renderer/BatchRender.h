@@ -0,0 +1,17 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <functional>
+
+namespace Renderer
+{
+    /** The render command: renders every WAV and AIFF file named on the command line,
+        or found in a folder named there, into the --output folder. Files are spread
+        over a thread pool with one processor per file, and each file's realtime
+        factor is printed as it finishes. */
+    void runBatchRender (const juce::ArgumentList& args);
+
+    /** Runs job (0) to job (numJobs - 1) on a pool of up to numThreads threads and
+        waits for all of them to finish. */
+    void runInParallel (int numJobs, int numThreads, const std::function<void (int)>& job);
+}
@@ -0,0 +1,217 @@
+#include "FileRenderer.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <type_traits>
+
+namespace Renderer
+{
+    namespace
+    {
+        // Big enough that the output reaches the disk in a few large writes
+        constexpr size_t writeBufferSize = 1 << 20;
+
+        double toSeconds (std::chrono::steady_clock::duration duration)
+        {
+            return std::chrono::duration<double> (duration).count();
+        }
+
+        /** Streams the segment through a processor from the reader into the writer. Files
+            are read and written as float, so a double render converts in between. */
+        template <typename SampleType>
+        bool process (juce::AudioFormatReader& reader, juce::AudioFormatWriter& writer,
+                      const DSP::Core::RenderSegment& segment, const RenderSettings& settings, RenderResult& result)
+        {
+            const auto numChannels = static_cast<int> (reader.numChannels);
+            const auto blockSize = settings.blockSize;
+
+            DSP::Core::ChasmDSPProcessor<SampleType> processor;
+            processor.prepare ({ reader.sampleRate, static_cast<juce::uint32> (blockSize), static_cast<juce::uint32> (numChannels) });
+            settings.plugin->applyParameters (processor);
+
+            juce::AudioBuffer<float> fileBuffer (numChannels, blockSize);
+            juce::AudioBuffer<SampleType> buffer (numChannels, blockSize);
+            std::chrono::steady_clock::duration fileTime {};
+
+            auto read = [&] (juce::int64 position, juce::AudioBuffer<SampleType>& block)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                auto& destination = [&]() -> juce::AudioBuffer<float>&
+                {
+                    if constexpr (std::is_same_v<SampleType, float>)
+                        return block;
+                    else
+                        return fileBuffer;
+                }();
+
+                // Memory-mapped readers refuse reads past the end, so the silence is added here
+                const auto numSamplesRead = static_cast<int> (juce::jlimit (static_cast<juce::int64> (0), static_cast<juce::int64> (blockSize),
+                                                                            reader.lengthInSamples - position));
+
+                if (numSamplesRead > 0 && ! reader.read (&destination, 0, numSamplesRead, position, true, true))
+                    return false;
+
+                destination.clear (numSamplesRead, blockSize - numSamplesRead);
+
+                if constexpr (! std::is_same_v<SampleType, float>)
+                    block.makeCopyOf (fileBuffer, true);
+
+                fileTime += std::chrono::steady_clock::now() - start;
+                return true;
+            };
+
+            auto write = [&] (const juce::AudioBuffer<SampleType>& block, int startSample, int numSamples)
+            {
+                const auto start = std::chrono::steady_clock::now();
+                auto written = false;
+
+                if constexpr (std::is_same_v<SampleType, float>)
+                {
+                    written = writer.writeFromAudioSampleBuffer (block, startSample, numSamples);
+                }
+                else
+                {
+                    fileBuffer.makeCopyOf (block, true);
+                    written = writer.writeFromAudioSampleBuffer (fileBuffer, startSample, numSamples);
+                }
+
+                fileTime += std::chrono::steady_clock::now() - start;
+                return written;
+            };
+
+            const auto start = std::chrono::steady_clock::now();
+
+            if (! DSP::Core::renderSegment (processor, segment, buffer, read, write))
+            {
+                result.error = "reading or writing failed";
+                return false;
+            }
+
+            result.processSeconds += toSeconds (std::chrono::steady_clock::now() - start - fileTime);
+            return true;
+        }
+    }
+
+    void printResult (const RenderResult& result)
+    {
+        if (result.error.isNotEmpty())
+        {
+            std::cerr << "failed: " << result.input.getFullPathName() << ": " << result.error << "\n";
+            return;
+        }
+
+        std::cout << std::fixed << std::setprecision (1)
+                  << std::setw (9) << result.audioSeconds << " s"
+                  << std::setw (8) << static_cast<int> (result.sampleRate) << " Hz"
+                  << std::setw (3) << result.numChannels << " ch"
+                  << "   realtime x" << std::setw (8) << result.getRealtimeFactor()
+                  << "   dsp x" << std::setw (8) << result.getProcessingRealtimeFactor()
+                  << "   " << result.input.getFileName() << "\n";
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> openInput (const juce::File& file, juce::AudioFormatManager& formats)
+    {
+        if (auto* format = formats.findFormatForFileExtension (file.getFileExtension()))
+        {
+            std::unique_ptr<juce::MemoryMappedAudioFormatReader> mappedReader (format->createMemoryMappedReader (file));
+
+            if (mappedReader != nullptr && mappedReader->mapEntireFile())
+                return mappedReader;
+        }
+
+        return std::unique_ptr<juce::AudioFormatReader> (formats.createReaderFor (file));
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> createWriter (const juce::File& output, const juce::AudioFormatReader& input,
+                                                           const RenderSettings& settings, juce::AudioFormatManager& formats)
+    {
+        auto* format = formats.findFormatForFileExtension (output.getFileExtension());
+
+        if (format == nullptr || (output.existsAsFile() && ! output.deleteFile()))
+            return {};
+
+        const auto bitDepths = format->getPossibleBitDepths();
+        auto bitsPerSample = settings.bitsPerSample;
+
+        if (bitsPerSample == 0)
+            bitsPerSample = bitDepths.contains (static_cast<int> (input.bitsPerSample)) ? static_cast<int> (input.bitsPerSample)
+                                                                                       : bitDepths.getLast();
+
+        if (! bitDepths.contains (bitsPerSample))
+            return {};
+
+        auto stream = output.createOutputStream (writeBufferSize);
+
+        if (stream == nullptr || stream->failedToOpen())
+            return {};
+
+        std::unique_ptr<juce::AudioFormatWriter> writer (format->createWriterFor (stream.get(), input.sampleRate, input.numChannels,
+                                                                                  bitsPerSample, input.metadataValues, 0));
+
+        // The writer owns the stream once it has been created
+        if (writer != nullptr)
+            stream.release();
+
+        return writer;
+    }
+
+    bool renderFileSegment (juce::AudioFormatReader& input, juce::AudioFormatWriter& output,
+                            const DSP::Core::RenderSegment& segment, const RenderSettings& settings, RenderResult& result)
+    {
+        return settings.doublePrecision ? process<double> (input, output, segment, settings, result)
+                                        : process<float> (input, output, segment, settings, result);
+    }
+
+    RenderResult renderFile (const juce::File& input, const juce::File& output,
+                             const RenderSettings& settings, juce::AudioFormatManager& formats)
+    {
+        RenderResult result;
+        result.input = input;
+        result.output = output;
+
+        const auto start = std::chrono::steady_clock::now();
+        auto reader = openInput (input, formats);
+
+        if (reader == nullptr)
+        {
+            result.error = "not a readable audio file";
+            return result;
+        }
+
+        result.sampleRate = reader->sampleRate;
+        result.numChannels = static_cast<int> (reader->numChannels);
+        result.audioSeconds = static_cast<double> (reader->lengthInSamples) / reader->sampleRate;
+
+        if (result.numChannels < 1 || result.numChannels > 2)
+        {
+            result.error = "only mono and stereo files can be rendered";
+            return result;
+        }
+
+        if (output == input)
+        {
+            result.error = "the output would overwrite the input";
+            return result;
+        }
+
+        auto writer = createWriter (output, *reader, settings, formats);
+
+        if (writer == nullptr)
+        {
+            result.error = "couldn't create " + output.getFullPathName();
+            return result;
+        }
+
+        const auto wholeFile = DSP::Core::planSegments (reader->lengthInSamples, 1, 0, settings.blockSize).front();
+        const auto succeeded = renderFileSegment (*reader, *writer, wholeFile, settings, result);
+
+        // Deleting the writer flushes the last of the buffer and finishes the header
+        writer.reset();
+        result.renderSeconds = toSeconds (std::chrono::steady_clock::now() - start);
+
+        if (! succeeded)
+            output.deleteFile();
+
+        return result;
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "RenderSettings.h"
+
+namespace Renderer
+{
+    /** What happened to one file. The error is empty on success. */
+    struct RenderResult
+    {
+        juce::File input, output;
+        juce::String error;
+        double sampleRate = 0.0;
+        int numChannels = 0;
+        double audioSeconds = 0.0;
+        double renderSeconds = 0.0;
+        double processSeconds = 0.0;
+
+        // Only set for segmented renders
+        int numSegments = 1;
+        double preRollSeconds = 0.0;
+
+        /** Seconds of audio rendered per second of wall time, reading and writing included. */
+        double getRealtimeFactor() const { return renderSeconds > 0.0 ? audioSeconds / renderSeconds : 0.0; }
+
+        /** The same for the DSP alone, per processor. */
+        double getProcessingRealtimeFactor() const { return processSeconds > 0.0 ? audioSeconds / processSeconds : 0.0; }
+    };
+
+    /** Prints a line with the result's realtime factors, or its error. */
+    void printResult (const RenderResult& result);
+
+    /** Opens a file for reading, memory-mapped where the format allows it and streamed otherwise. */
+    std::unique_ptr<juce::AudioFormatReader> openInput (const juce::File& file, juce::AudioFormatManager& formats);
+
+    /** Creates a writer for output through a large write buffer, in the format given by
+        its extension, at the rate and channel count of the input and at the settings'
+        bit depth, or the input's if none was given. */
+    std::unique_ptr<juce::AudioFormatWriter> createWriter (const juce::File& output, const juce::AudioFormatReader& input,
+                                                           const RenderSettings& settings, juce::AudioFormatManager& formats);
+
+    /** Renders one segment of the input through its own processor into the writer, see
+        DSP::Core::renderSegment(). Adds the time spent in the DSP to the result, or
+        sets its error. */
+    bool renderFileSegment (juce::AudioFormatReader& input, juce::AudioFormatWriter& output,
+                            const DSP::Core::RenderSegment& segment, const RenderSettings& settings, RenderResult& result);
+
+    /** Renders one file through its own processor, prepared at the file's sample rate.
+        The output is compensated for the processor's latency, so it lines up with the
+        input sample for sample and has the same length. Safe to call from several
+        threads at once. */
+    RenderResult renderFile (const juce::File& input, const juce::File& output,
+                             const RenderSettings& settings, juce::AudioFormatManager& formats);
+}
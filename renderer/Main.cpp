@@ -0,0 +1,44 @@
+#include "BatchRender.h"
+#include "SegmentedRender.h"
+#include <juce_events/juce_events.h>
+
+int main (int argc, char* argv[])
+{
+    // The plugin instance that holds the parameters expects JUCE to be initialised
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+    app.addHelpCommand ("--help|-h", "Renders audio files through Chasm without a host.", true);
+    app.addVersionCommand ("--version|-v", juce::String ("ChasmRender ") + VERSION);
+
+    app.addCommand ({ "render",
+                      "render <files or folders>... --output=<folder> [--preset=<name or file>] [--param=<ID>=<value>]... "
+                      "[--threads=<n>] [--block-size=<n>] [--bits=<n>] [--double]",
+                      "Renders WAV and AIFF files in parallel, one file per thread.",
+                      "Every file goes through its own processor at the file's sample rate, and is written to the output "
+                      "folder under the same name, latency compensated and at the same bit depth unless --bits is given, so no two inputs may share a name. Parameters start at "
+                      "their defaults, then the preset is loaded (a path, or the name of a preset saved by the plugin) "
+                      "and each --param is set on top, in the parameter's own units, e.g. --param=DELAY=45 or "
+                      "--param=SOFT_CLIP=on. --threads defaults to the number of CPUs.",
+                      Renderer::runBatchRender });
+
+    app.addCommand ({ "render-segmented",
+                      "render-segmented <file> --output=<file> [--segments=<n>] [--preset=<name or file>] "
+                      "[--param=<ID>=<value>]... [--threads=<n>] [--block-size=<n>] [--bits=<n>] [--double]",
+                      "Renders one long file in segments, in parallel.",
+                      "The file is cut into --segments pieces, by default one per CPU, at block boundaries. Each piece "
+                      "goes through its own processor, which first runs over the audio before it for as long as the "
+                      "processor needs to reach the state a sequential render would be in, so the pieces join without "
+                      "seams. The other options are the same as for render.",
+                      Renderer::runSegmentedRender });
+
+    app.addCommand ({ "verify",
+                      "verify <file> [--segments=<n>] [--tolerance=<dBFS>] [--preset=<name or file>] "
+                      "[--param=<ID>=<value>]... [--threads=<n>] [--block-size=<n>] [--double]",
+                      "Checks that a segmented render matches a sequential one.",
+                      "Renders the file both ways at 32-bit float and compares them sample by sample. Fails if they "
+                      "differ by more than --tolerance, which defaults to -100 dBFS, the level Chasm treats as silence.",
+                      Renderer::runVerify });
+
+    return app.findAndRunCommand (juce::ArgumentList (argc, argv), true);
+}
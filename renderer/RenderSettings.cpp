@@ -0,0 +1,110 @@
+#include "RenderSettings.h"
+
+namespace Renderer
+{
+    namespace
+    {
+        juce::String getParameterID (const juce::AudioProcessorParameter& parameter)
+        {
+            if (auto* withID = dynamic_cast<const juce::AudioProcessorParameterWithID*> (&parameter))
+                return withID->paramID;
+
+            return {};
+        }
+
+        juce::String listParameterIDs (PluginProcessor& plugin)
+        {
+            juce::StringArray ids;
+
+            for (auto* parameter : plugin.getParameters())
+                ids.add (getParameterID (*parameter));
+
+            return ids.joinIntoString (", ");
+        }
+
+        /** Loads a preset saved by the plugin, either from a path or by name from the
+            plugin's preset folder. */
+        void loadPreset (PluginProcessor& plugin, const juce::String& nameOrPath)
+        {
+            auto file = juce::File::getCurrentWorkingDirectory().getChildFile (nameOrPath);
+
+            if (! file.existsAsFile())
+                file = Service::PresetManager::defaultDirectory.getChildFile (nameOrPath + "." + Service::PresetManager::extension);
+
+            if (! file.existsAsFile())
+                juce::ConsoleApplication::fail ("Couldn't find the preset " + nameOrPath);
+
+            const auto xml = juce::XmlDocument::parse (file);
+
+            if (xml == nullptr || ! xml->hasTagName (plugin.apvts.state.getType()))
+                juce::ConsoleApplication::fail (file.getFullPathName() + " is not a Chasm preset");
+
+            plugin.apvts.replaceState (juce::ValueTree::fromXml (*xml));
+        }
+
+        /** Sets one parameter from ID=value, with the value in the parameter's own
+            units (dB, ms, %) or on/off for switches. */
+        void setParameter (PluginProcessor& plugin, const juce::String& assignment)
+        {
+            const auto id = assignment.upToFirstOccurrenceOf ("=", false, false).trim().toUpperCase();
+            const auto text = assignment.fromFirstOccurrenceOf ("=", false, false).trim();
+            auto* parameter = plugin.apvts.getParameter (id);
+
+            if (parameter == nullptr)
+                juce::ConsoleApplication::fail ("Unknown parameter '" + id + "', expected one of " + listParameterIDs (plugin));
+
+            const auto isNumber = text.isNotEmpty() && text.containsOnly ("0123456789.-+eE");
+
+            if (! isNumber && ! (parameter->isBoolean() && text.isNotEmpty()))
+                juce::ConsoleApplication::fail ("Can't set " + id + " to '" + text + "'");
+
+            parameter->setValueNotifyingHost (parameter->getValueForText (text));
+        }
+    }
+
+    RenderSettings RenderSettings::fromArguments (const juce::ArgumentList& args)
+    {
+        RenderSettings settings;
+        settings.plugin = std::make_unique<PluginProcessor>();
+        settings.numThreads = juce::SystemStats::getNumCpus();
+
+        if (args.containsOption ("--preset"))
+            loadPreset (*settings.plugin, args.getValueForOption ("--preset"));
+
+        for (const auto& argument : args.arguments)
+            if (argument.isLongOption ("--param"))
+                setParameter (*settings.plugin, argument.getLongOptionValue());
+
+        if (args.containsOption ("--block-size"))
+            settings.blockSize = args.getValueForOption ("--block-size").getIntValue();
+
+        if (args.containsOption ("--threads"))
+            settings.numThreads = args.getValueForOption ("--threads").getIntValue();
+
+        if (args.containsOption ("--bits"))
+            settings.bitsPerSample = args.getValueForOption ("--bits").getIntValue();
+
+        if (settings.blockSize < 1)
+            juce::ConsoleApplication::fail ("--block-size must be at least 1");
+
+        if (settings.numThreads < 1)
+            juce::ConsoleApplication::fail ("--threads must be at least 1");
+
+        if (settings.bitsPerSample < 0)
+            juce::ConsoleApplication::fail ("--bits must be a bit depth such as 16, 24 or 32");
+
+        settings.doublePrecision = args.containsOption ("--double");
+
+        return settings;
+    }
+
+    juce::String RenderSettings::describeParameters() const
+    {
+        juce::StringArray values;
+
+        for (auto* parameter : plugin->getParameters())
+            values.add (getParameterID (*parameter) + "=" + parameter->getCurrentValueAsText() + parameter->getLabel());
+
+        return values.joinIntoString (" ");
+    }
+}
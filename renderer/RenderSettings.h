@@ -0,0 +1,27 @@
+#pragma once
+
+#include "PluginProcessor.h"
+#include <memory>
+
+namespace Renderer
+{
+    /** Everything a render needs apart from the audio. The parameter values live in a
+        plugin instance that never plays, so ranges, defaults and presets behave
+        exactly as they do in a session. */
+    struct RenderSettings
+    {
+        /** Reads the settings from the command line, failing the command on anything
+            it doesn't understand. A --preset is loaded first and every --param is
+            applied on top of it. */
+        static RenderSettings fromArguments (const juce::ArgumentList& args);
+
+        /** Returns every parameter with its value, for the log. */
+        juce::String describeParameters() const;
+
+        std::unique_ptr<PluginProcessor> plugin;
+        int blockSize = 512;
+        int numThreads = 1;
+        int bitsPerSample = 0;
+        bool doublePrecision = false;
+    };
+}
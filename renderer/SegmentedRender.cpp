@@ -0,0 +1,295 @@
+#include "SegmentedRender.h"
+#include "BatchRender.h"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace Renderer
+{
+    namespace
+    {
+        /** The file named on the command line. The first argument is the command itself. */
+        juce::File getInputFile (const juce::ArgumentList& args)
+        {
+            for (int i = 1; i < args.size(); ++i)
+            {
+                if (args[i].isOption())
+                    continue;
+
+                const auto file = args[i].resolveAsFile();
+
+                if (! file.existsAsFile())
+                    juce::ConsoleApplication::fail (file.getFullPathName() + " is not a file");
+
+                return file;
+            }
+
+            juce::ConsoleApplication::fail ("No input file given");
+            return {};
+        }
+
+        int getNumSegments (const juce::ArgumentList& args)
+        {
+            if (! args.containsOption ("--segments"))
+                return juce::SystemStats::getNumCpus();
+
+            const auto numSegments = args.getValueForOption ("--segments").getIntValue();
+
+            if (numSegments < 1)
+                juce::ConsoleApplication::fail ("--segments must be at least 1");
+
+            return numSegments;
+        }
+
+        /** Asks a processor prepared for the file and the settings how much pre-roll it needs. */
+        int getPreRollSamples (const juce::AudioFormatReader& reader, const RenderSettings& settings)
+        {
+            DSP::FloatProcessor processor;
+            processor.prepare ({ reader.sampleRate, static_cast<juce::uint32> (settings.blockSize), reader.numChannels });
+            settings.plugin->applyParameters (processor);
+
+            return processor.getPreRollSamples();
+        }
+
+        struct Comparison
+        {
+            double maxDifference = 0.0;
+            juce::int64 maxDifferencePosition = 0;
+            juce::int64 numDifferentSamples = 0;
+        };
+
+        /** Compares two files of the same length sample by sample. */
+        bool compareFiles (const juce::File& first, const juce::File& second, juce::AudioFormatManager& formats, Comparison& comparison)
+        {
+            constexpr int blockSize = 1 << 16;
+
+            auto firstReader = openInput (first, formats);
+            auto secondReader = openInput (second, formats);
+
+            if (firstReader == nullptr || secondReader == nullptr
+                || firstReader->numChannels != secondReader->numChannels
+                || firstReader->lengthInSamples != secondReader->lengthInSamples)
+                return false;
+
+            const auto numChannels = static_cast<int> (firstReader->numChannels);
+            const auto length = firstReader->lengthInSamples;
+            juce::AudioBuffer<float> firstBuffer (numChannels, blockSize);
+            juce::AudioBuffer<float> secondBuffer (numChannels, blockSize);
+
+            for (juce::int64 position = 0; position < length; position += blockSize)
+            {
+                const auto numSamples = static_cast<int> (juce::jmin (static_cast<juce::int64> (blockSize), length - position));
+
+                if (! firstReader->read (&firstBuffer, 0, numSamples, position, true, true)
+                    || ! secondReader->read (&secondBuffer, 0, numSamples, position, true, true))
+                    return false;
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    const auto* firstData = firstBuffer.getReadPointer (channel);
+                    const auto* secondData = secondBuffer.getReadPointer (channel);
+
+                    for (int i = 0; i < numSamples; ++i)
+                    {
+                        const auto difference = static_cast<double> (std::abs (firstData[i] - secondData[i]));
+
+                        if (difference == 0.0)
+                            continue;
+
+                        ++comparison.numDifferentSamples;
+
+                        if (difference > comparison.maxDifference)
+                        {
+                            comparison.maxDifference = difference;
+                            comparison.maxDifferencePosition = position + i;
+                        }
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        void printSegments (const RenderResult& result)
+        {
+            std::cout << std::fixed << std::setprecision (1)
+                      << result.numSegments << " segments, each warmed up with " << result.preRollSeconds << " s of pre-roll\n";
+        }
+    }
+
+    RenderResult renderFileSegmented (const juce::File& input, const juce::File& output, const RenderSettings& settings,
+                                      int numSegments, juce::AudioFormatManager& formats)
+    {
+        RenderResult result;
+        result.input = input;
+        result.output = output;
+
+        const auto start = std::chrono::steady_clock::now();
+        auto reader = openInput (input, formats);
+
+        if (reader == nullptr)
+        {
+            result.error = "not a readable audio file";
+            return result;
+        }
+
+        result.sampleRate = reader->sampleRate;
+        result.numChannels = static_cast<int> (reader->numChannels);
+        result.audioSeconds = static_cast<double> (reader->lengthInSamples) / reader->sampleRate;
+
+        if (result.numChannels < 1 || result.numChannels > 2)
+        {
+            result.error = "only mono and stereo files can be rendered";
+            return result;
+        }
+
+        if (output == input)
+        {
+            result.error = "the output would overwrite the input";
+            return result;
+        }
+
+        const auto preRollSamples = getPreRollSamples (*reader, settings);
+        const auto segments = DSP::Core::planSegments (reader->lengthInSamples, numSegments, preRollSamples, settings.blockSize);
+        const auto numPlannedSegments = static_cast<int> (segments.size());
+
+        result.numSegments = numPlannedSegments;
+        result.preRollSeconds = preRollSamples / reader->sampleRate;
+
+        // Every segment reads the input through its own reader and writes its own file
+        std::vector<std::unique_ptr<juce::TemporaryFile>> segmentFiles;
+        std::vector<RenderResult> segmentResults (segments.size());
+
+        for (int i = 0; i < numPlannedSegments; ++i)
+            segmentFiles.push_back (std::make_unique<juce::TemporaryFile> (output));
+
+        runInParallel (numPlannedSegments, settings.numThreads, [&] (int i)
+        {
+            const auto index = static_cast<size_t> (i);
+            auto& segmentResult = segmentResults[index];
+            auto segmentReader = openInput (input, formats);
+            auto writer = segmentReader != nullptr ? createWriter (segmentFiles[index]->getFile(), *segmentReader, settings, formats) : nullptr;
+
+            if (writer == nullptr)
+                segmentResult.error = "couldn't create a temporary file next to " + output.getFullPathName();
+            else
+                renderFileSegment (*segmentReader, *writer, segments[index], settings, segmentResult);
+        });
+
+        for (const auto& segmentResult : segmentResults)
+        {
+            if (segmentResult.error.isNotEmpty())
+            {
+                result.error = segmentResult.error;
+                return result;
+            }
+
+            result.processSeconds += segmentResult.processSeconds;
+        }
+
+        // Join the segments, which are already at the output's bit depth, so copying them is lossless
+        auto writer = createWriter (output, *reader, settings, formats);
+
+        if (writer == nullptr)
+        {
+            result.error = "couldn't create " + output.getFullPathName();
+            return result;
+        }
+
+        for (const auto& segmentFile : segmentFiles)
+        {
+            auto segmentReader = openInput (segmentFile->getFile(), formats);
+
+            if (segmentReader == nullptr || ! writer->writeFromAudioReader (*segmentReader, 0, -1))
+            {
+                result.error = "joining the segments failed";
+                break;
+            }
+        }
+
+        writer.reset();
+        result.renderSeconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+
+        if (result.error.isNotEmpty())
+            output.deleteFile();
+
+        return result;
+    }
+
+    void runSegmentedRender (const juce::ArgumentList& args)
+    {
+        const auto input = getInputFile (args);
+        const auto output = args.getFileForOption ("--output");
+        const auto numSegments = getNumSegments (args);
+        const auto settings = RenderSettings::fromArguments (args);
+
+        std::cout << "Rendering " << input.getFileName() << " in up to " << numSegments << " segments on "
+                  << settings.numThreads << " threads with\n" << settings.describeParameters() << "\n";
+
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        const auto result = renderFileSegmented (input, output, settings, numSegments, formats);
+        printResult (result);
+
+        if (result.error.isNotEmpty())
+            juce::ConsoleApplication::fail ("Rendering failed");
+
+        printSegments (result);
+    }
+
+    void runVerify (const juce::ArgumentList& args)
+    {
+        const auto input = getInputFile (args);
+        const auto numSegments = getNumSegments (args);
+        auto settings = RenderSettings::fromArguments (args);
+
+        const auto toleranceDb = args.containsOption ("--tolerance") ? args.getValueForOption ("--tolerance").getDoubleValue()
+                                                                     : DSP::FloatProcessor::silenceThresholdDb;
+
+        // Compare the renders before they are rounded to the input's bit depth
+        settings.bitsPerSample = 32;
+
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        juce::TemporaryFile sequentialFile (".wav");
+        juce::TemporaryFile segmentedFile (".wav");
+
+        std::cout << "Sequential render:\n";
+        const auto sequential = renderFile (input, sequentialFile.getFile(), settings, formats);
+        printResult (sequential);
+
+        std::cout << "Segmented render:\n";
+        const auto segmented = renderFileSegmented (input, segmentedFile.getFile(), settings, numSegments, formats);
+        printResult (segmented);
+
+        if (sequential.error.isNotEmpty() || segmented.error.isNotEmpty())
+            juce::ConsoleApplication::fail ("Rendering failed");
+
+        printSegments (segmented);
+
+        Comparison comparison;
+
+        if (! compareFiles (sequentialFile.getFile(), segmentedFile.getFile(), formats, comparison))
+            juce::ConsoleApplication::fail ("Couldn't compare the renders");
+
+        std::cout << std::fixed << std::setprecision (2) << "Speedup x" << sequential.renderSeconds / segmented.renderSeconds << "\n";
+
+        if (comparison.numDifferentSamples == 0)
+        {
+            std::cout << "The renders are bit-identical\n";
+            return;
+        }
+
+        const auto maxDifferenceDb = 20.0 * std::log10 (comparison.maxDifference);
+
+        std::cout << std::setprecision (1) << comparison.numDifferentSamples << " samples differ, by up to "
+                  << maxDifferenceDb << " dBFS at " << comparison.maxDifferencePosition / segmented.sampleRate << " s\n";
+
+        if (maxDifferenceDb > toleranceDb)
+            juce::ConsoleApplication::fail ("The renders differ by more than the tolerance of " + juce::String (toleranceDb, 1) + " dBFS");
+    }
+}
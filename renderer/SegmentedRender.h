@@ -0,0 +1,21 @@
+#pragma once
+
+#include "FileRenderer.h"
+
+namespace Renderer
+{
+    /** Renders one long file as up to numSegments segments in parallel, each on its own
+        processor warmed up with the pre-roll from ChasmDSPProcessor::getPreRollSamples(),
+        and joins them into the output. The segments are rendered to temporary files
+        next to the output, so they never need to fit in memory. */
+    RenderResult renderFileSegmented (const juce::File& input, const juce::File& output, const RenderSettings& settings,
+                                      int numSegments, juce::AudioFormatManager& formats);
+
+    /** The render-segmented command: renders a single file with renderFileSegmented(). */
+    void runSegmentedRender (const juce::ArgumentList& args);
+
+    /** The verify command: renders a file both sequentially and in segments, at 32-bit
+        float, and compares the two sample by sample. Fails if they differ by more than
+        the --tolerance in dBFS, which defaults to the processor's silence threshold. */
+    void runVerify (const juce::ArgumentList& args);
+}
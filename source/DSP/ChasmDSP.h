@@ -7,25 +7,33 @@
  * - Schroeder Allpass Filter Chain for reverb/delay effects
  * - Stereo Enhancer for width control and frequency-dependent processing
  * - Simple filters for EQ and frequency shaping
- * - Limiter for output protection
+ * - Linkwitz-Riley crossover bank for multiband width
+ * - Lookahead true-peak limiter for output protection
+ * - Oversampled soft clipper
  * - Parameter smoothing utilities
+ * - A per-processor state arena for component memory
  * - Complete DSP processor
+ * - Segment planning and rendering for parallel offline renders
  */
 
 // Utility classes
 #include "Utils/ParameterSmoother.h"
+#include "Utils/StateArena.h"
 
 // Filter components
 #include "Filters/AllpassFilter.h"
 #include "Filters/SchroederAllpassChain.h"
 #include "Filters/SimpleFilter.h"
+#include "Filters/LinkwitzRileyCrossover.h"
 
 // Effect components
 #include "Effects/StereoEnhancer.h"
 #include "Effects/Limiter.h"
+#include "Effects/SoftClipper.h"
 
 // Core DSP processor
 #include "Core/ChasmDSPProcessor.h"
+#include "Core/OfflineRender.h"
 
 namespace DSP {
 
@@ -44,13 +52,25 @@ using DoubleAllpassFilter = Filters::AllpassFilter<double>;
 using FloatAllpassChain = Filters::SchroederAllpassChain<float>;
 using DoubleAllpassChain = Filters::SchroederAllpassChain<double>;
 
+using FloatStereoAllpassChain = Filters::SchroederAllpassChain<float, 2>;
+using DoubleStereoAllpassChain = Filters::SchroederAllpassChain<double, 2>;
+
+using FloatQuadAllpassChain = Filters::SchroederAllpassChain<float, 4>;
+using DoubleQuadAllpassChain = Filters::SchroederAllpassChain<double, 4>;
+
 using FloatSimpleFilter = Filters::SimpleFilter<float>;
 using DoubleSimpleFilter = Filters::SimpleFilter<double>;
 
+using FloatCrossoverBank = Filters::LinkwitzRileyCrossoverBank<float>;
+using DoubleCrossoverBank = Filters::LinkwitzRileyCrossoverBank<double>;
+
 using FloatStereoEnhancer = Effects::StereoEnhancer<float>;
 using DoubleStereoEnhancer = Effects::StereoEnhancer<double>;
 
-using FloatLimiter = Effects::SmoothLimiter<float>;
-using DoubleLimiter = Effects::SmoothLimiter<double>;
+using FloatLimiter = Effects::LookaheadLimiter<float>;
+using DoubleLimiter = Effects::LookaheadLimiter<double>;
+
+using FloatSoftClipper = Effects::OversampledSoftClipper<float>;
+using DoubleSoftClipper = Effects::OversampledSoftClipper<double>;
 
 } // namespace DSP
@@ -2,14 +2,24 @@
 
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <vector>
 
 // DSP Components
 #include "../Utils/ParameterSmoother.h"
 #include "../Utils/DSPUtils.h"
+#include "../Utils/StateArena.h"
 #include "../Filters/SchroederAllpassChain.h"
 #include "../Filters/EQFilters.h"
 #include "../Effects/StereoEnhancer.h"
 #include "../Effects/Limiter.h"
+#include "../Effects/SoftClipper.h"
 
 namespace DSP {
 namespace Core {
@@ -17,37 +27,112 @@ namespace Core {
 /**
  * Main DSP Processor for Chasm.
  * Coordinates all DSP components with parameter smoothing.
+ *
+ * The delay lines, limiter and clipper histories and coefficient tables of all
+ * components are carved out of one StateArena, sized in prepare() for the
+ * sample rate, so an instance's DSP state is a single cache-aligned allocation.
+ * That makes the whole running state cheap to copy: takeSnapshot() and
+ * restoreSnapshot() move it in and out of a preallocated Snapshot with two flat
+ * copies, which is enough for A/B compare without re-priming the tail, or for
+ * forking an offline render.
  */
 template<typename SampleType>
 class ChasmDSPProcessor
 {
 public:
+    /** Number of samples between parameter and coefficient updates. */
+    static constexpr int controlBlockSize = 32;
+    
+    /** Level below which input and output count as silence (-100 dB). The reported
+        tail is the time the allpass chain takes to decay to this level. */
+    static constexpr double silenceThresholdDb = -100.0;
+    
+    /** Everything that changes while the processor runs, apart from the contents of
+        the state arena: filter and limiter state, smoother values and silence
+        detection. Trivially copyable, so it copies as one flat block. */
+    struct State
+    {
+        typename Filters::SchroederAllpassChain<SampleType, 2>::State allpassChain;
+        typename Filters::BrightnessEQ<SampleType, 2>::State brightnessEQ;
+        typename Filters::DualCutFilter<SampleType, 2>::State dualCutFilter;
+        Effects::StereoEnhancer<SampleType> stereoEnhancer;
+        typename Effects::OversampledSoftClipper<SampleType>::State softClipper;
+        typename Effects::LookaheadLimiter<SampleType>::State limiter;
+        
+        Utils::ParameterSmoother<SampleType> inputGainSmoother;
+        Utils::ParameterSmoother<SampleType> outputGainSmoother;
+        Utils::ParameterSmoother<SampleType> mixSmoother;
+        Utils::ParameterSmoother<SampleType> delaySmoother;
+        Utils::ParameterSmoother<SampleType> brightnessSmoother;
+        Utils::ParameterSmoother<SampleType> characterSmoother;
+        Utils::ParameterSmoother<SampleType> lowCutSmoother;
+        Utils::ParameterSmoother<SampleType> highCutSmoother;
+        Utils::ParameterSmoother<SampleType> widthSmoother;
+        
+        bool componentsNeedUpdate;
+        bool bypassed;
+        int bypassIndex;
+        int silentInputSamples;
+        int tailSamples;
+        bool sleeping;
+        double tailLengthSeconds;
+        SampleType lastTailDelay;
+        SampleType lastTailCharacter;
+    };
+    
+    static_assert(std::is_trivially_copyable_v<State>, "Snapshots are copied as flat memory");
+    
+    /** A copy of a processor's complete running state, see takeSnapshot(). */
+    class Snapshot
+    {
+    public:
+        /** Returns true once a state has been taken into the snapshot. */
+        bool hasState() const { return taken; }
+        
+    private:
+        friend class ChasmDSPProcessor;
+        
+        std::vector<std::byte> arenaContents;
+        State state {};
+        double sampleRate = 0.0;
+        bool taken = false;
+    };
+    
     ChasmDSPProcessor() = default;
     
     /** Prepares all DSP components. */
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
         sampleRate = spec.sampleRate;
-        samplesPerBlock = static_cast<int>(spec.maximumBlockSize);
-        numChannels = static_cast<int>(spec.numChannels);
         
-        // Prepare all DSP components
-        leftAllpassChain.prepare(sampleRate);  // Max 100ms delay
-        rightAllpassChain.prepare(sampleRate);
+        // Prepare all DSP components, with their memory in the state arena
+        const juce::dsp::ProcessSpec controlSpec { sampleRate, static_cast<juce::uint32>(controlBlockSize), static_cast<juce::uint32>(wetScratch.size()) };
         
-        brightnessEQ.prepare(spec);
-        dualCutFilter.prepare(spec);
+        stateArena.build([&](Utils::StateArena& arena)
+        {
+            allpassChain.prepare(sampleRate, arena);
+            brightnessEQ.prepare(spec, arena);
+            dualCutFilter.prepare(spec, arena);
+            softClipper.prepare(controlSpec, arena);
+            limiter.prepare(controlSpec, arena);
+            
+            bypassDelayLength = juce::jmax(1, getLatencySamples());
+            bypassDelay = arena.allocate<SampleType>(wetScratch.size() * static_cast<size_t>(bypassDelayLength));
+        });
+        
+        // The cut and brightness controls act on the whole wet signal, so the enhancer's
+        // own side filters stay fully open. reset() below lands it on these settings
+        stereoEnhancer.prepare(sampleRate);
         stereoEnhancer.setWidth(SampleType{100.0}); // Default 100% width
-        limiter.prepare(sampleRate);
+        stereoEnhancer.setLowCut(SampleType{0.0});
+        stereoEnhancer.setHighCut(SampleType{100.0});
+        stereoEnhancer.setBrightness(SampleType{0.0});
         
         // Prepare parameter smoothers with their respective smoothing times
         prepareParameterSmoothers();
         
-        // Create working buffers
-        wetBuffer.setSize(numChannels, samplesPerBlock);
-        dryBuffer.setSize(numChannels, samplesPerBlock);
-        
         reset();
+        updateTailLength();
     }
     
     /** Updates all parameters with smoothing. */
@@ -56,97 +141,302 @@ public:
                          SampleType lowCutPercent, SampleType highCutPercent, SampleType widthPercent,
                          bool limiterEnabled)
     {
-        // Update all parameter smoothers
-        inputGainSmoother.setTargetValue(Utils::DSPUtils::dbToGain(inputGainDb));
-        outputGainSmoother.setTargetValue(Utils::DSPUtils::dbToGain(outputGainDb));
+        setInputGain(inputGainDb);
+        setOutputGain(outputGainDb);
+        setMix(mixPercent);
+        setDelay(delayMs);
+        setBrightness(brightnessDb);
+        setCharacter(characterQ);
+        setLowCut(lowCutPercent);
+        setHighCut(highCutPercent);
+        setWidth(widthPercent);
+        setLimiterEnabled(limiterEnabled);
+    }
+    
+    /** Sets the input gain in dB. */
+    void setInputGain(SampleType inputGainDb)
+    {
+        inputGainSmoother.setTargetValue(Utils::DSPUtils::fastDbToGain(inputGainDb));
+    }
+    
+    /** Sets the output gain in dB. */
+    void setOutputGain(SampleType outputGainDb)
+    {
+        outputGainSmoother.setTargetValue(Utils::DSPUtils::fastDbToGain(outputGainDb));
+    }
+    
+    /** Sets the dry/wet mix (0-100%). */
+    void setMix(SampleType mixPercent)
+    {
         mixSmoother.setTargetValue(Utils::DSPUtils::percentageToNormalized(mixPercent));
+    }
+    
+    /** Sets the base delay time in milliseconds. */
+    void setDelay(SampleType delayMs)
+    {
         delaySmoother.setTargetValue(delayMs);
+    }
+    
+    /** Sets the brightness in dB (-12 to +12). */
+    void setBrightness(SampleType brightnessDb)
+    {
         brightnessSmoother.setTargetValue(brightnessDb);
+    }
+    
+    /** Sets the character of the allpass chain. */
+    void setCharacter(SampleType characterQ)
+    {
         characterSmoother.setTargetValue(characterQ);
+    }
+    
+    /** Sets the low cut amount (0-100%). */
+    void setLowCut(SampleType lowCutPercent)
+    {
         lowCutSmoother.setTargetValue(lowCutPercent);
+    }
+    
+    /** Sets the high cut amount (0-100%). */
+    void setHighCut(SampleType highCutPercent)
+    {
         highCutSmoother.setTargetValue(highCutPercent);
+    }
+    
+    /** Sets the stereo width (0-200%). */
+    void setWidth(SampleType widthPercent)
+    {
         widthSmoother.setTargetValue(widthPercent);
-        
+    }
+    
+    /** Enables or disables multiband width in the stereo enhancer. */
+    void setMultibandWidthEnabled(bool multibandEnabled)
+    {
+        stereoEnhancer.setMultibandEnabled(multibandEnabled);
+    }
+    
+    /** Sets the width of one multiband width band (0-200%), lowest band first.
+        The enhancer smooths band widths itself. */
+    void setBandWidth(size_t band, SampleType widthPercent)
+    {
+        stereoEnhancer.setBandWidth(band, widthPercent);
+    }
+    
+    /** Enables or disables the output limiter. */
+    void setLimiterEnabled(bool limiterEnabled)
+    {
         // Limiter is not smoothed (binary parameter)
         limiter.setEnabled(limiterEnabled);
     }
     
-    /** Processes a block of audio. */
+    /** Engages or bypasses the oversampled soft clipper ahead of the limiter. */
+    void setSoftClipEnabled(bool softClipEnabled)
+    {
+        softClipper.setEnabled(softClipEnabled);
+    }
+    
+    /** Bypasses or engages the processor. While bypassed the dry input comes out
+        delayed by getLatencySamples(), so it stays aligned with the host's latency
+        compensation. When processing resumes, every component starts from silence
+        rather than replaying audio from before the bypass. */
+    void setBypassed(bool shouldBeBypassed)
+    {
+        if (bypassed && !shouldBeBypassed)
+            clearAudioState();
+        
+        bypassed = shouldBeBypassed;
+    }
+    
+    /** Returns true while the processor is bypassed. */
+    bool isBypassed() const { return bypassed; }
+    
+    /** Processes a block of audio in place.
+        The block is cut into control-rate sub-blocks: smoothed parameters and
+        filter coefficients are updated once per sub-block, and every stage then
+        runs over the whole sub-block before the next stage starts. The wet path
+        lives in a small scratch region, so the buffer is only ever read once and
+        the mixed, gained and limited result is written straight back into it.
+
+        Since every stage only ever sees one control block, any block size works,
+        including ones larger than the maximum passed to prepare(), and nothing is
+        allocated or resized when the size changes from call to call. */
     void processBlock(juce::AudioBuffer<SampleType>& buffer)
     {
         jassert(buffer.getNumChannels() >= 1);
         
+        // The components flush their own feedback paths, but the JUCE oversampling
+        // filters do not, so don't rely on the host having enabled flush-to-zero
+        juce::ScopedNoDenormals noDenormals;
+        
         int numSamples = buffer.getNumSamples();
         
-        // Ensure working buffers are the right size
-        if (wetBuffer.getNumSamples() != numSamples)
-        {
-            wetBuffer.setSize(numChannels, numSamples, false, false, true);
-            dryBuffer.setSize(numChannels, numSamples, false, false, true);
-        }
+        // The bypass delay always sees the input, so bypassing never outputs stale audio
+        processBypassDelay(buffer, bypassed);
         
-        // Store dry signal
-        dryBuffer.makeCopyOf(buffer);
+        if (bypassed)
+            return;
         
-        // Process each sample with parameter smoothing
-        for (int i = 0; i < numSamples; ++i)
+        // Once the input has been silent for longer than the tail and the output has
+        // died away too, the whole chain sleeps until non-silent input arrives
+        const bool inputSilent = buffer.getMagnitude(0, numSamples) <= silenceThreshold;
+        
+        if (!inputSilent)
         {
-            // Get smoothed parameter values for this sample
-            SampleType inputGain = inputGainSmoother.getNextValue();
-            SampleType outputGain = outputGainSmoother.getNextValue();
-            SampleType mix = mixSmoother.getNextValue();
-            SampleType delay = delaySmoother.getNextValue();
-            SampleType brightness = brightnessSmoother.getNextValue();
-            SampleType character = characterSmoother.getNextValue();
-            SampleType lowCut = lowCutSmoother.getNextValue();
-            SampleType highCut = highCutSmoother.getNextValue();
-            SampleType width = widthSmoother.getNextValue();
-            
-            // Update DSP components with smoothed values
-            if (i == 0 || shouldUpdateDSPComponents(i))
-            {
-                updateDSPComponents(delay, brightness, character, lowCut, highCut, width);
-            }
-            
-            // Process single sample
-            processSingleSample(buffer, i, inputGain, outputGain, mix);
+            silentInputSamples = 0;
+            sleeping = false;
         }
-
-        // Apply stereo enhancement ONCE per buffer (if stereo)
-        if (buffer.getNumChannels() >= 2)
+        else if (sleeping)
         {
-            stereoEnhancer.processBlock(wetBuffer);
+            advanceSmoothers(numSamples);
+            buffer.clear();
+            return;
         }
-
-        // After enhancement, mix dry/wet and apply output gain
-        for (int i = 0; i < numSamples; ++i)
+        
+        for (int startSample = 0; startSample < numSamples; startSample += controlBlockSize)
         {
-            for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
-            {
-                auto* channelData = buffer.getWritePointer(channel);
-                SampleType drySample = dryBuffer.getSample(channel, i);
-                SampleType wetSample = wetBuffer.getSample(channel, i);
-                SampleType mix = mixSmoother.getCurrentValue();
-                SampleType outputGain = outputGainSmoother.getCurrentValue();
-                SampleType mixedSample = drySample * (SampleType{1.0} - mix) + wetSample * mix;
-                channelData[i] = mixedSample * outputGain;
-            }
+            processControlBlock(buffer, startSample, juce::jmin(controlBlockSize, numSamples - startSample));
         }
-
-        // Apply final limiter
-        limiter.processBlock(buffer);
+        
+        if (inputSilent)
+        {
+            silentInputSamples = juce::jmin(silentInputSamples + numSamples, std::numeric_limits<int>::max() / 2);
+            
+            if (silentInputSamples >= tailSamples + getLatencySamples()
+                && buffer.getMagnitude(0, numSamples) <= silenceThreshold)
+                sleeping = true;
+        }
+    }
+    
+    /** Returns true while the processor is skipping all DSP on silent input. */
+    bool isSleeping() const { return sleeping; }
+    
+    /** Returns how long the output keeps ringing after the input stops, in seconds,
+        for the current delay and character. Safe to call from any thread. */
+    double getTailLengthSeconds() const
+    {
+        return tailLengthSeconds.load(std::memory_order_relaxed);
     }
     
+    /** Returns the latency added by the soft clipper and lookahead limiter, in samples. */
+    int getLatencySamples() const
+    {
+        return softClipper.getLatencySamples() + limiter.getLatencySamples();
+    }
+    
+    /** Returns how much earlier input a freshly prepared processor has to run through
+        before its output matches, to within silenceThresholdDb, a processor that has
+        been running all along with the same parameters. That is the time for the
+        smoothers to land on their targets, then for the allpass tail and the limiter
+        release to die away at those settings, plus the latency.
+        Used to warm up the segments of a parallel offline render, see OfflineRender.h.
+        Call it once the parameters are set. */
+    int getPreRollSamples() const
+    {
+        // The delay passes through two 50 ms smoothers in series, this one and the
+        // chain's, which is the slowest path any parameter takes
+        const auto settleSamples = 2 * delaySmoother.getSettlingSamples(maxRelativeParameterJump);
+        
+        const auto tailSeconds = allpassChain.getTailLengthSeconds(-silenceThresholdDb, delaySmoother.getTargetValue(),
+                                                                   characterSmoother.getTargetValue());
+        const auto tailLength = static_cast<int>(std::ceil(tailSeconds * sampleRate));
+        
+        return settleSamples + tailLength + limiter.getReleaseSamples(-silenceThresholdDb)
+             + getLatencySamples() + controlBlockSize;
+    }
+    
+    /** Allocates room in snapshot for this processor's state at its current settings.
+        Call after prepare() and off the audio thread; the snapshot then stays valid
+        for takeSnapshot() until the processor is prepared differently. */
+    void prepareSnapshot(Snapshot& snapshot) const
+    {
+        snapshot.arenaContents.resize(stateArena.getSize());
+        snapshot.taken = false;
+    }
+    
+    /** Copies the complete running state into a snapshot prepared with
+        prepareSnapshot(). Doesn't allocate, so it is safe on the audio thread
+        between calls to processBlock(). Returns false if the snapshot was prepared
+        for different settings. */
+    bool takeSnapshot(Snapshot& snapshot) const
+    {
+        if (snapshot.arenaContents.size() != stateArena.getSize())
+            return false;
+        
+        std::memcpy(snapshot.arenaContents.data(), stateArena.getData(), stateArena.getSize());
+        
+        snapshot.state = { allpassChain.getState(), brightnessEQ.getState(), dualCutFilter.getState(),
+                           stereoEnhancer, softClipper.getState(), limiter.getState(),
+                           inputGainSmoother, outputGainSmoother, mixSmoother, delaySmoother,
+                           brightnessSmoother, characterSmoother, lowCutSmoother, highCutSmoother,
+                           widthSmoother, componentsNeedUpdate, bypassed, bypassIndex, silentInputSamples, tailSamples,
+                           sleeping, tailLengthSeconds.load(std::memory_order_relaxed),
+                           lastTailDelay, lastTailCharacter };
+        
+        snapshot.sampleRate = sampleRate;
+        snapshot.taken = true;
+        return true;
+    }
+    
+    /** Replaces the running state with one taken from this or another processor
+        prepared with the same settings, so processing carries on exactly where the
+        snapshot was taken. Doesn't allocate, so it is safe on the audio thread
+        between calls to processBlock(). Returns false, leaving the state alone, if
+        the snapshot holds no state or was taken at different settings.
+        The soft clipper's oversampling filters are not part of the snapshot; if the
+        clipper is engaged they restart from silence. */
+    bool restoreSnapshot(const Snapshot& snapshot)
+    {
+        if (!snapshot.taken || snapshot.sampleRate != sampleRate
+            || snapshot.arenaContents.size() != stateArena.getSize())
+            return false;
+        
+        std::memcpy(stateArena.getData(), snapshot.arenaContents.data(), stateArena.getSize());
+        
+        const auto& state = snapshot.state;
+        allpassChain.setState(state.allpassChain);
+        brightnessEQ.setState(state.brightnessEQ);
+        dualCutFilter.setState(state.dualCutFilter);
+        stereoEnhancer = state.stereoEnhancer;
+        softClipper.setState(state.softClipper);
+        limiter.setState(state.limiter);
+        
+        inputGainSmoother = state.inputGainSmoother;
+        outputGainSmoother = state.outputGainSmoother;
+        mixSmoother = state.mixSmoother;
+        delaySmoother = state.delaySmoother;
+        brightnessSmoother = state.brightnessSmoother;
+        characterSmoother = state.characterSmoother;
+        lowCutSmoother = state.lowCutSmoother;
+        highCutSmoother = state.highCutSmoother;
+        widthSmoother = state.widthSmoother;
+        
+        componentsNeedUpdate = state.componentsNeedUpdate;
+        bypassed = state.bypassed;
+        bypassIndex = state.bypassIndex;
+        silentInputSamples = state.silentInputSamples;
+        tailSamples = state.tailSamples;
+        sleeping = state.sleeping;
+        tailLengthSeconds.store(state.tailLengthSeconds, std::memory_order_relaxed);
+        lastTailDelay = state.lastTailDelay;
+        lastTailCharacter = state.lastTailCharacter;
+        
+        return true;
+    }
+    
+    /** Returns the arena holding the components' delay lines, histories and tables. */
+    const Utils::StateArena& getStateArena() const { return stateArena; }
+    
     /** Resets all DSP components. */
     void reset()
     {
-        leftAllpassChain.reset();
-        rightAllpassChain.reset();
+        allpassChain.reset();
         brightnessEQ.reset();
         dualCutFilter.reset();
         stereoEnhancer.reset();
+        softClipper.reset();
         limiter.reset();
         
+        std::fill(bypassDelay.begin(), bypassDelay.end(), SampleType{0});
+        bypassIndex = 0;
+        
         // Reset parameter smoothers
         inputGainSmoother.reset(SampleType{1.0});
         outputGainSmoother.reset(SampleType{1.0});
@@ -157,9 +447,70 @@ public:
         lowCutSmoother.reset(SampleType{0.0});
         highCutSmoother.reset(SampleType{0.0});
         widthSmoother.reset(SampleType{100.0});
+        
+        // Components may hold settings that no longer match the smoothers
+        componentsNeedUpdate = true;
+        
+        silentInputSamples = 0;
+        sleeping = false;
     }
 
 private:
+    /** Silences every component but keeps the parameters, landing the smoothers on
+        their targets since there is no earlier output left to glide from. */
+    void clearAudioState()
+    {
+        inputGainSmoother.snapToTargetValue();
+        outputGainSmoother.snapToTargetValue();
+        mixSmoother.snapToTargetValue();
+        delaySmoother.snapToTargetValue();
+        brightnessSmoother.snapToTargetValue();
+        characterSmoother.snapToTargetValue();
+        lowCutSmoother.snapToTargetValue();
+        highCutSmoother.snapToTargetValue();
+        widthSmoother.snapToTargetValue();
+        
+        allpassChain.reset(delaySmoother.getTargetValue(), characterSmoother.getTargetValue());
+        brightnessEQ.reset();
+        dualCutFilter.reset();
+        stereoEnhancer.reset();
+        softClipper.reset();
+        limiter.reset();
+        
+        componentsNeedUpdate = true;
+        silentInputSamples = 0;
+        sleeping = false;
+    }
+    
+    /** Pushes the first two channels through a delay of getLatencySamples(), replacing
+        them with the delayed signal only when writeOutput is set. */
+    void processBypassDelay(juce::AudioBuffer<SampleType>& buffer, bool writeOutput)
+    {
+        const int numChannels = juce::jmin(buffer.getNumChannels(), static_cast<int>(wetScratch.size()));
+        const int numSamples = buffer.getNumSamples();
+        
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* delayLine = bypassDelay.data() + channel * bypassDelayLength;
+            auto* samples = buffer.getWritePointer(channel);
+            auto index = bypassIndex;
+            
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto delayed = delayLine[index];
+                delayLine[index] = samples[i];
+                
+                if (writeOutput)
+                    samples[i] = delayed;
+                
+                if (++index == bypassDelayLength)
+                    index = 0;
+            }
+        }
+        
+        bypassIndex = (bypassIndex + numSamples) % bypassDelayLength;
+    }
+    
     void prepareParameterSmoothers()
     {
         // Prepare smoothers with their specified smoothing times
@@ -174,103 +525,167 @@ private:
         widthSmoother.prepare(sampleRate, 20.0);      // 20ms
     }
     
-    bool shouldUpdateDSPComponents(int sampleIndex)
-    {
-        // Update DSP components every 32 samples to balance quality vs performance
-        return (sampleIndex % 32) == 0;
-    }
-    
-    void updateDSPComponents(SampleType delay, SampleType brightness, SampleType character,
-                           SampleType lowCut, SampleType highCut, SampleType width)
+    /** Advances the component smoothers by one control block and pushes their values
+        into the DSP components. A component is only touched while its smoother is
+        still moving, so settled parameters cost nothing per block. */
+    void updateDSPComponents(int numSamples)
     {
-        // Update allpass chains
-        leftAllpassChain.setDelayTime(delay);
-        rightAllpassChain.setDelayTime(delay);
-        leftAllpassChain.setCharacter(character);
-        rightAllpassChain.setCharacter(character);
+        const bool forceUpdate = componentsNeedUpdate;
+        componentsNeedUpdate = false;
+        
+        // Update allpass chain
+        if (forceUpdate || delaySmoother.isSmoothing())
+            allpassChain.setDelayTime(delaySmoother.skip(numSamples));
+        
+        if (forceUpdate || characterSmoother.isSmoothing())
+            allpassChain.setCharacter(characterSmoother.skip(numSamples));
+        
+        if (forceUpdate || delaySmoother.getCurrentValue() != lastTailDelay || characterSmoother.getCurrentValue() != lastTailCharacter)
+            updateTailLength();
         
         // Update EQ and filters
-        brightnessEQ.setBrightness(brightness);
-        dualCutFilter.setLowCut(lowCut);
-        dualCutFilter.setHighCut(highCut);
+        if (forceUpdate || brightnessSmoother.isSmoothing())
+            brightnessEQ.setBrightness(brightnessSmoother.skip(numSamples));
+        
+        if (forceUpdate || lowCutSmoother.isSmoothing())
+            dualCutFilter.setLowCut(lowCutSmoother.skip(numSamples));
+        
+        if (forceUpdate || highCutSmoother.isSmoothing())
+            dualCutFilter.setHighCut(highCutSmoother.skip(numSamples));
         
         // Update stereo enhancer
-        stereoEnhancer.setWidth(width);
+        if (forceUpdate || widthSmoother.isSmoothing())
+            stereoEnhancer.setWidth(widthSmoother.skip(numSamples));
     }
     
-    void processSingleSample(juce::AudioBuffer<SampleType>& buffer, int sampleIndex,
-                           SampleType inputGain, SampleType outputGain, SampleType mix)
+    /** Estimates the tail from the allpass chain's current settings. */
+    void updateTailLength()
     {
-        // Apply input gain
-        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
-        {
-            auto* channelData = buffer.getWritePointer(channel);
-            channelData[sampleIndex] *= inputGain;
-        }
+        lastTailDelay = delaySmoother.getCurrentValue();
+        lastTailCharacter = characterSmoother.getCurrentValue();
         
-        // Store wet signal for processing
-        for (int channel = 0; channel < juce::jmin(wetBuffer.getNumChannels(), buffer.getNumChannels()); ++channel)
+        auto seconds = allpassChain.getTailLengthSeconds(-silenceThresholdDb);
+        tailSamples = static_cast<int>(std::ceil(seconds * sampleRate));
+        tailLengthSeconds.store(seconds, std::memory_order_relaxed);
+    }
+    
+    /** Moves the parameters on by numSamples while the chain sleeps, so changes made
+        during silence (and the tail estimate) are in place when processing resumes. */
+    void advanceSmoothers(int numSamples)
+    {
+        inputGainSmoother.skip(numSamples);
+        outputGainSmoother.skip(numSamples);
+        mixSmoother.skip(numSamples);
+        updateDSPComponents(numSamples);
+    }
+    
+    void processControlBlock(juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples)
+    {
+        // Gains and mix are ramped linearly across the sub-block, everything else steps once
+        const auto inputGainStart = inputGainSmoother.getCurrentValue();
+        const auto inputGainEnd = inputGainSmoother.skip(numSamples);
+        const auto outputGainStart = outputGainSmoother.getCurrentValue();
+        const auto outputGainEnd = outputGainSmoother.skip(numSamples);
+        const auto mixStart = mixSmoother.getCurrentValue();
+        const auto mixEnd = mixSmoother.skip(numSamples);
+        
+        updateDSPComponents(numSamples);
+        
+        const int numWetChannels = juce::jmin(buffer.getNumChannels(), static_cast<int>(wetScratch.size()));
+        const auto blockLength = static_cast<SampleType>(numSamples);
+        const auto inputGainStep = (inputGainEnd - inputGainStart) / blockLength;
+        const auto outputGainStep = (outputGainEnd - outputGainStart) / blockLength;
+        const auto mixStep = (mixEnd - mixStart) / blockLength;
+        
+        // Single read of the input: the wet copy goes to scratch and the dry
+        // contribution is written back in place
+        for (int channel = 0; channel < numWetChannels; ++channel)
         {
-            wetBuffer.setSample(channel, sampleIndex, buffer.getSample(channel, sampleIndex));
+            auto* channelData = buffer.getWritePointer(channel, startSample);
+            auto* wetData = wetScratch[static_cast<size_t>(channel)].data();
+            auto inputGain = inputGainStart;
+            auto outputGain = outputGainStart;
+            auto mix = mixStart;
+            
+            for (int i = 0; i < numSamples; ++i)
+            {
+                inputGain += inputGainStep;
+                outputGain += outputGainStep;
+                mix += mixStep;
+                
+                const auto drySample = channelData[i];
+                wetData[i] = drySample * inputGain;
+                channelData[i] = drySample * (SampleType{1.0} - mix) * outputGain;
+            }
         }
         
-        // Process through DSP chain
-        if (buffer.getNumChannels() >= 2)
+        // Process through DSP chain, one stage at a time
+        auto* left = wetScratch[0].data();
+        auto* right = wetScratch[1].data();
+        
+        processFilterChain(left, numWetChannels >= 2 ? right : nullptr, numSamples);
+        
+        if (numWetChannels >= 2)
+            stereoEnhancer.processBlock(left, right, numSamples);
+        
+        // Add the wet signal with output gain
+        std::array<SampleType*, 2> channels {};
+        
+        for (int channel = 0; channel < numWetChannels; ++channel)
         {
-            // Stereo processing
-            SampleType leftSample = wetBuffer.getSample(0, sampleIndex);
-            SampleType rightSample = wetBuffer.getSample(1, sampleIndex);
-            
-            // Allpass filtering
-            leftSample = leftAllpassChain.processSample(leftSample);
-            rightSample = rightAllpassChain.processSample(rightSample);
-            
-            // EQ and filtering
-            leftSample = brightnessEQ.processSample(leftSample);
-            rightSample = brightnessEQ.processSample(rightSample);
-            
-            leftSample = dualCutFilter.processSample(leftSample);
-            rightSample = dualCutFilter.processSample(rightSample);
-            
-            wetBuffer.setSample(0, sampleIndex, leftSample);
-            wetBuffer.setSample(1, sampleIndex, rightSample);
-            
-            // Stereo enhancement (removed from per-sample processing)
-            // stereoEnhancer.processStereoSample(leftSample, rightSample);
+            auto* channelData = buffer.getWritePointer(channel, startSample);
+            channels[static_cast<size_t>(channel)] = channelData;
+            const auto* wetData = wetScratch[static_cast<size_t>(channel)].data();
+            auto outputGain = outputGainStart;
+            auto mix = mixStart;
             
+            for (int i = 0; i < numSamples; ++i)
+            {
+                outputGain += outputGainStep;
+                mix += mixStep;
+                channelData[i] += wetData[i] * mix * outputGain;
+            }
         }
-        else if (buffer.getNumChannels() == 1)
+        
+        // Anti-aliased soft clipping, then stereo-linked limiting in place
+        softClipper.process(channels.data(), numWetChannels, numSamples);
+        limiter.process(channels.data(), numWetChannels, numSamples);
+    }
+    
+    /** Runs both channels through the allpass chain, brightness EQ and cut filters
+        as interleaved stereo frames, so every stage handles both channels at once.
+        A mono signal runs in the left lane with silence in the right one. */
+    void processFilterChain(SampleType* left, SampleType* right, int numSamples)
+    {
+        auto* frames = wetFrames.data();
+        
+        for (int i = 0; i < numSamples; ++i)
         {
-            // Mono processing
-            SampleType sample = wetBuffer.getSample(0, sampleIndex);
-            
-            // Process through left chain only for mono
-            sample = leftAllpassChain.processSample(sample);
-            sample = brightnessEQ.processSample(sample);
-            sample = dualCutFilter.processSample(sample);
-            
-            wetBuffer.setSample(0, sampleIndex, sample);
+            frames[2 * i] = left[i];
+            frames[2 * i + 1] = right != nullptr ? right[i] : SampleType{0};
         }
         
-        // Mix dry and wet signals with output gain
-        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        allpassChain.processBlock(frames, numSamples);
+        brightnessEQ.processFrames(frames, numSamples);
+        dualCutFilter.processFrames(frames, numSamples);
+        
+        for (int i = 0; i < numSamples; ++i)
         {
-            auto* channelData = buffer.getWritePointer(channel);
-            SampleType drySample = dryBuffer.getSample(channel, sampleIndex);
-            SampleType wetSample = wetBuffer.getSample(channel, sampleIndex);
+            left[i] = frames[2 * i];
             
-            SampleType mixedSample = drySample * (SampleType{1.0} - mix) + wetSample * mix;
-            channelData[sampleIndex] = mixedSample * outputGain;
+            if (right != nullptr)
+                right[i] = frames[2 * i + 1];
         }
     }
     
-    // DSP Components
-    Filters::SchroederAllpassChain<SampleType> leftAllpassChain;
-    Filters::SchroederAllpassChain<SampleType> rightAllpassChain;
-    Filters::BrightnessEQ<SampleType> brightnessEQ;
-    Filters::DualCutFilter<SampleType> dualCutFilter;
+    // DSP Components, and the memory they share
+    Utils::StateArena stateArena;
+    Filters::SchroederAllpassChain<SampleType, 2> allpassChain;
+    Filters::BrightnessEQ<SampleType, 2> brightnessEQ;
+    Filters::DualCutFilter<SampleType, 2> dualCutFilter;
     Effects::StereoEnhancer<SampleType> stereoEnhancer;
-    Effects::SmoothLimiter<SampleType> limiter;
+    Effects::OversampledSoftClipper<SampleType> softClipper;
+    Effects::LookaheadLimiter<SampleType> limiter;
     
     // Parameter Smoothers
     Utils::ParameterSmoother<SampleType> inputGainSmoother;
@@ -283,14 +698,36 @@ private:
     Utils::ParameterSmoother<SampleType> highCutSmoother;
     Utils::ParameterSmoother<SampleType> widthSmoother;
     
-    // Working buffers
-    juce::AudioBuffer<SampleType> wetBuffer;
-    juce::AudioBuffer<SampleType> dryBuffer;
+    // Wet path scratch for one control block, small enough to stay in L1
+    alignas(64) std::array<std::array<SampleType, controlBlockSize>, 2> wetScratch {};
+    alignas(64) std::array<SampleType, controlBlockSize * 2> wetFrames {};
+    
+    // Set when every component must be refreshed on the next control block
+    bool componentsNeedUpdate = true;
+    
+    // Bypass, with a delay matching the latency for the dry signal
+    std::span<SampleType> bypassDelay;
+    int bypassDelayLength = 1;
+    int bypassIndex = 0;
+    bool bypassed = false;
+    
+    // The largest parameter change relative to its target, a width or band width
+    // dropping from its 100 % default to 0 %, used to bound the smoothers' settling time
+    static constexpr double maxRelativeParameterJump = 100.0;
+    
+    // Silence detection
+    static constexpr SampleType silenceThreshold = static_cast<SampleType>(1.0e-5); // silenceThresholdDb as a gain
+    int silentInputSamples = 0;
+    int tailSamples = 0;
+    bool sleeping = false;
+    
+    // Tail estimate and the settings it was made for
+    std::atomic<double> tailLengthSeconds { 0.0 };
+    SampleType lastTailDelay = SampleType{0};
+    SampleType lastTailCharacter = SampleType{0};
     
     // Audio settings
     double sampleRate = 44100.0;
-    int samplesPerBlock = 512;
-    int numChannels = 2;
 };
 
 } // namespace Core
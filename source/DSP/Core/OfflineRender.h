@@ -0,0 +1,107 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <algorithm>
+#include <vector>
+#include "ChasmDSPProcessor.h"
+
+namespace DSP {
+namespace Core {
+
+/**
+ * One stretch of an offline render. Output samples [start, end) come from a
+ * processor that starts on the input at preRollStart, so it has settled into the
+ * same state as a processor that ran from the beginning by the time it reaches
+ * start. Output positions are latency compensated: output sample n lines up with
+ * input sample n.
+ */
+struct RenderSegment
+{
+    juce::int64 preRollStart = 0;
+    juce::int64 start = 0;
+    juce::int64 end = 0;
+};
+
+/**
+ * Splits numSamples of input into at most numSegments contiguous segments of
+ * about equal length, for rendering in parallel on separate processors and
+ * stitching back together.
+ *
+ * Every segment except the first is warmed up with preRollSamples of the input
+ * before it, see ChasmDSPProcessor::getPreRollSamples(). All boundaries fall on
+ * multiples of blockSize, so when each segment is rendered in blocks of
+ * blockSize its processBlock() calls and control blocks line up exactly with
+ * those of one processor rendering the whole input, and the only difference left
+ * is the state the segment's processor started from.
+ */
+inline std::vector<RenderSegment> planSegments(juce::int64 numSamples, int numSegments,
+                                               juce::int64 preRollSamples, int blockSize)
+{
+    jassert(numSegments > 0 && blockSize > 0 && preRollSamples >= 0);
+    
+    auto roundUpToBlock = [blockSize](juce::int64 value)
+    {
+        return (value + blockSize - 1) / blockSize * blockSize;
+    };
+    
+    const auto segmentLength = juce::jmax(static_cast<juce::int64>(blockSize),
+                                          roundUpToBlock((numSamples + numSegments - 1) / juce::jmax(1, numSegments)));
+    const auto preRoll = roundUpToBlock(preRollSamples);
+    
+    std::vector<RenderSegment> segments;
+    
+    for (juce::int64 start = 0; start < numSamples; start += segmentLength)
+        segments.push_back({ juce::jmax(static_cast<juce::int64>(0), start - preRoll), start, juce::jmin(start + segmentLength, numSamples) });
+    
+    // An empty input still gets one (empty) segment, so it still produces an output
+    if (segments.empty())
+        segments.push_back({});
+    
+    return segments;
+}
+
+/**
+ * Renders one segment through processor, which should be freshly prepared with
+ * its parameters set, in blocks the size of buffer.
+ *
+ * read(position, buffer) must fill the whole buffer with the input starting at
+ * position, with silence past the end of the input, and return false if it
+ * fails. write(buffer, startSample, numSamples) receives the segment's output in
+ * order, latency compensated, and returns false if it fails. Past the end of the
+ * segment the processor keeps running on the input until its latency is flushed.
+ *
+ * Returns false as soon as read or write fails.
+ */
+template<typename SampleType, typename ReadFunction, typename WriteFunction>
+bool renderSegment(ChasmDSPProcessor<SampleType>& processor, const RenderSegment& segment,
+                   juce::AudioBuffer<SampleType>& buffer, ReadFunction&& read, WriteFunction&& write)
+{
+    const auto blockSize = static_cast<juce::int64>(buffer.getNumSamples());
+    jassert(blockSize > 0);
+    
+    // The processor's first output is latency samples behind the first input it gets
+    auto samplesToSkip = segment.start - segment.preRollStart + processor.getLatencySamples();
+    auto samplesToWrite = segment.end - segment.start;
+    
+    for (auto position = segment.preRollStart; samplesToWrite > 0; position += blockSize)
+    {
+        if (!read(position, buffer))
+            return false;
+        
+        processor.processBlock(buffer);
+        
+        const auto skipped = std::min(samplesToSkip, blockSize);
+        const auto numSamples = std::min(samplesToWrite, blockSize - skipped);
+        samplesToSkip -= skipped;
+        
+        if (numSamples > 0 && !write(buffer, static_cast<int>(skipped), static_cast<int>(numSamples)))
+            return false;
+        
+        samplesToWrite -= numSamples;
+    }
+    
+    return true;
+}
+
+} // namespace Core
+} // namespace DSP
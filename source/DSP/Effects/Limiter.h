@@ -2,7 +2,14 @@
 
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_dsp/juce_dsp.h>
+#include "../Utils/DSPUtils.h"
+#include "../Utils/SIMDLanes.h"
+#include "../Utils/StateArena.h"
+#include <array>
 #include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <span>
 
 namespace DSP {
 namespace Effects {
@@ -10,6 +17,9 @@ namespace Effects {
 /**
  * Smooth Limiter for preventing clipping and adding character.
  * Uses a combination of soft clipping and dynamic range compression.
+ *
+ * Legacy: ChasmDSPProcessor uses LookaheadLimiter instead. This one is only kept
+ * so the benchmarks can compare against it.
  */
 template<typename SampleType>
 class SmoothLimiter
@@ -17,13 +27,14 @@ class SmoothLimiter
 public:
     SmoothLimiter() = default;
         
-    /** Prepares the limiter with sample rate. */
-        void prepare(double newSampleRate)
+    /** Prepares the limiter with the processing spec. */
+        void prepare(const juce::dsp::ProcessSpec& spec)
         {
-            _sampleRate = newSampleRate;
+            _sampleRate = spec.sampleRate;
             
             // Prepare the compressor for the limiting stage
-            _compressor.prepare({_sampleRate, 256, 2});
+            _compressor.prepare(spec);
+            updateCoefficients();
             
             // Configure compressor for limiting
             _compressor.setAttack(SampleType{0.1});   // 0.1ms attack
@@ -95,6 +106,9 @@ public:
         // Apply compressor for final limiting stage
         if (numChannels > 0)
         {
+            // The compressor's envelope does not flush itself, so keep it clear of denormals here
+            juce::ScopedNoDenormals noDenormals;
+            
             juce::dsp::AudioBlock<SampleType> block(buffer);
             juce::dsp::ProcessContextReplacing<SampleType> context(block);
             _compressor.process(context);
@@ -120,7 +134,7 @@ private:
     SampleType softClip(SampleType input)
     {
         // Smooth soft clipping using tanh
-        return std::tanh(input * SampleType{2.0}) * SampleType{0.5};
+        return Utils::DSPUtils::fastTanh(input * SampleType{2.0}) * SampleType{0.5};
     }
     
     SampleType dynamicLimit(SampleType input)
@@ -140,6 +154,9 @@ private:
             _envelopeFollower += (inputLevel - _envelopeFollower) * _releaseCoeff;
         }
         
+        // The release decays towards zero on silence, so keep it out of the denormal range
+        _envelopeFollower = Utils::DSPUtils::flushDenormalToZero(_envelopeFollower);
+        
         // Calculate gain reduction
         SampleType gainReduction = SampleType{1.0};
         if (_envelopeFollower > _threshold)
@@ -173,6 +190,342 @@ private:
     juce::dsp::Compressor<SampleType> _compressor;
 };
 
+/**
+ * Lookahead true-peak limiter.
+ *
+ * The audio is delayed by the lookahead time so gain reduction is fully applied
+ * before a peak arrives. The detector takes the larger of the sample peak and the
+ * inter-sample peaks found by the ITU-R BS.1770 4x true-peak interpolator across
+ * all channels, so every channel receives the same stereo-linked gain.
+ *
+ * The required gain is held over the lookahead window by an O(1) sliding minimum
+ * (monotonic deque), released exponentially and then averaged over the lookahead
+ * window, which turns the hold into a smooth attack that reaches the target
+ * exactly when the peak reaches the output. The hold also covers half the
+ * interpolator's length on either side of each peak, so the output samples that
+ * make up its inter-sample peaks all get the reduced gain. A final clamp at the
+ * ceiling keeps the output brickwall should rounding let a sample through.
+ *
+ * The latency stays the same whether the limiter is enabled or not, so the host
+ * only needs getLatencySamples() once after prepare().
+ *
+ * The delay and detector memory comes from a StateArena, its own or a processor's.
+ */
+template<typename SampleType>
+class LookaheadLimiter
+{
+public:
+    LookaheadLimiter() = default;
+    
+    /** Sets the lookahead time in milliseconds. This changes the latency, so it
+        takes effect on the next prepare(). */
+    void setLookahead(double newLookaheadMs)
+    {
+        lookaheadMs = juce::jmax(0.0, newLookaheadMs);
+    }
+    
+    /** Prepares the limiter, allocating all delay and detector memory. */
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        ownedState.build([&](Utils::StateArena& arena) { prepare(spec, arena); });
+    }
+    
+    /** Prepares the limiter, taking all delay and detector memory from arena
+        (see StateArena::build). */
+    void prepare(const juce::dsp::ProcessSpec& spec, Utils::StateArena& arena)
+    {
+        sampleRate = spec.sampleRate;
+        numChannels = static_cast<int>(spec.numChannels);
+        
+        lookaheadSamples = juce::jmax(1, juce::roundToInt(lookaheadMs * 0.001 * sampleRate));
+        holdLength = lookaheadSamples + 2 * holdGuard;
+        delayLength = lookaheadSamples + truePeakDelay + holdGuard;
+        
+        delayLines = arena.allocate<SampleType>(static_cast<size_t>(numChannels * delayLength));
+        peakHistory = arena.allocate<SampleType>(static_cast<size_t>(numChannels * truePeakTaps * 2));
+        holdValues = arena.allocate<SampleType>(static_cast<size_t>(holdLength + 2));
+        holdTimes = arena.allocate<uint32_t>(static_cast<size_t>(holdLength + 2));
+        averageValues = arena.allocate<SampleType>(static_cast<size_t>(lookaheadSamples));
+        averageScale = SampleType{1} / static_cast<SampleType>(lookaheadSamples);
+        
+        setRelease(releaseMs);
+        reset();
+    }
+    
+    /** Enables or disables gain reduction. While disabled the audio is still
+        delayed, so the latency does not change, and the detector keeps running,
+        so the samples already in the delay are limited as soon as it is enabled. */
+    void setEnabled(bool shouldBeEnabled)
+    {
+        enabled = shouldBeEnabled;
+    }
+    
+    /** Sets the output ceiling in dBTP. The conversion is exact rather than
+        fastDbToGain, since the ceiling is the level the output must never pass. */
+    void setCeiling(SampleType ceilingDb)
+    {
+        ceiling = juce::Decibels::decibelsToGain(ceilingDb);
+    }
+    
+    /** Sets the release time in milliseconds. prepare() calls this and nothing on the
+        audio thread does, so it keeps the exact std::exp. */
+    void setRelease(double newReleaseMs)
+    {
+        releaseMs = juce::jmax(0.1, newReleaseMs);
+        releaseCoeff = static_cast<SampleType>(1.0 - std::exp(-1.0 / (releaseMs * 0.001 * sampleRate)));
+    }
+    
+    /** Returns how many samples the release takes to recover all but decayDb of a
+        gain change. */
+    int getReleaseSamples(double decayDb) const
+    {
+        const auto decayPerSample = std::log(1.0 - static_cast<double>(releaseCoeff));
+        return static_cast<int>(std::ceil(-decayDb / 20.0 * std::log(10.0) / decayPerSample));
+    }
+    
+    /** Returns the delay added to the signal, in samples. */
+    int getLatencySamples() const
+    {
+        return delayLength;
+    }
+    
+    /** Processes numSamples samples of each channel in place. */
+    void process(SampleType* const* channels, int numChannelsToProcess, int numSamples)
+    {
+        jassert(numChannelsToProcess <= numChannels);
+        numChannelsToProcess = juce::jmin(numChannelsToProcess, numChannels);
+        
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // The detector runs while disabled too, so the gain is already right for
+            // the delayed samples when the limiter is enabled again
+            auto peak = SampleType{0};
+            
+            for (int channel = 0; channel < numChannelsToProcess; ++channel)
+                peak = juce::jmax(peak, detectPeak(channel, channels[channel][i]));
+            
+            if (++historyIndex == truePeakTaps)
+                historyIndex = 0;
+            
+            const auto gain = computeGain(peak > ceiling ? ceiling / peak : SampleType{1});
+            
+            for (int channel = 0; channel < numChannelsToProcess; ++channel)
+            {
+                auto& delayed = delayLines[static_cast<size_t>(channel * delayLength + delayIndex)];
+                auto output = enabled ? juce::jlimit(-ceiling, ceiling, delayed * gain) : delayed;
+                
+                delayed = channels[channel][i];
+                channels[channel][i] = output;
+            }
+            
+            if (++delayIndex == delayLength)
+                delayIndex = 0;
+        }
+    }
+    
+    /** Processes a buffer. */
+    void processBlock(juce::AudioBuffer<SampleType>& buffer)
+    {
+        process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples());
+    }
+    
+    /** Resets the limiter state. */
+    void reset()
+    {
+        std::fill(delayLines.begin(), delayLines.end(), SampleType{0});
+        std::fill(peakHistory.begin(), peakHistory.end(), SampleType{0});
+        delayIndex = 0;
+        historyIndex = 0;
+        resetGain();
+    }
+    
+    /** The limiter's running state apart from its delay and detector memory, which
+        lives in its StateArena. Only valid for limiters prepared with the same settings. */
+    struct State
+    {
+        bool enabled;
+        SampleType ceiling;
+        SampleType releaseCoeff;
+        int delayIndex;
+        int historyIndex;
+        size_t holdFront;
+        size_t holdCount;
+        uint32_t sampleCounter;
+        SampleType averageSum;
+        SampleType releasedGain;
+        int averageIndex;
+    };
+    
+    /** Returns the running state, see State. */
+    State getState() const
+    {
+        return { enabled, ceiling, releaseCoeff, delayIndex, historyIndex, holdFront,
+                 holdCount, sampleCounter, averageSum, releasedGain, averageIndex };
+    }
+    
+    /** Restores a state returned by getState(). */
+    void setState(const State& state)
+    {
+        enabled = state.enabled;
+        ceiling = state.ceiling;
+        releaseCoeff = state.releaseCoeff;
+        delayIndex = state.delayIndex;
+        historyIndex = state.historyIndex;
+        holdFront = state.holdFront;
+        holdCount = state.holdCount;
+        sampleCounter = state.sampleCounter;
+        averageSum = state.averageSum;
+        releasedGain = state.releasedGain;
+        averageIndex = state.averageIndex;
+    }
+    
+    /** Gets the current gain reduction in dB. */
+    SampleType getGainReduction() const
+    {
+        return juce::Decibels::gainToDecibels(averageSum * averageScale);
+    }
+
+private:
+    // Inter-sample peaks are found by the 4 phase, 12 tap interpolator of ITU-R
+    // BS.1770 Annex 2, which delays the detector by 6 samples
+    static constexpr int truePeakTaps = 12;
+    static constexpr int truePeakDelay = truePeakTaps / 2;
+    
+    // Samples either side of a peak that must share its gain
+    static constexpr int holdGuard = truePeakTaps / 2;
+    
+    // One lane per interpolator phase
+    using PeakLanes = Utils::LaneVector<SampleType, 4>;
+    
+    // The BS.1770 coefficients, stored per tap so all phases run at once
+    alignas(16) static constexpr std::array<std::array<SampleType, 4>, truePeakTaps> truePeakCoefficients {{
+        { SampleType( 0.0017089843750), SampleType(-0.0291748046875), SampleType(-0.0189208984375), SampleType(-0.0083007812500) },
+        { SampleType( 0.0109863281250), SampleType( 0.0292968750000), SampleType( 0.0330810546875), SampleType( 0.0148925781250) },
+        { SampleType(-0.0196533203125), SampleType(-0.0517578125000), SampleType(-0.0582275390625), SampleType(-0.0266113281250) },
+        { SampleType( 0.0332031250000), SampleType( 0.0891113281250), SampleType( 0.1015625000000), SampleType( 0.0476074218750) },
+        { SampleType(-0.0594482421875), SampleType(-0.1665039062500), SampleType(-0.2003173828125), SampleType(-0.1022949218750) },
+        { SampleType( 0.1373291015625), SampleType( 0.4650878906250), SampleType( 0.7797851562500), SampleType( 0.9721679687500) },
+        { SampleType( 0.9721679687500), SampleType( 0.7797851562500), SampleType( 0.4650878906250), SampleType( 0.1373291015625) },
+        { SampleType(-0.1022949218750), SampleType(-0.2003173828125), SampleType(-0.1665039062500), SampleType(-0.0594482421875) },
+        { SampleType( 0.0476074218750), SampleType( 0.1015625000000), SampleType( 0.0891113281250), SampleType( 0.0332031250000) },
+        { SampleType(-0.0266113281250), SampleType(-0.0582275390625), SampleType(-0.0517578125000), SampleType(-0.0196533203125) },
+        { SampleType( 0.0148925781250), SampleType( 0.0330810546875), SampleType( 0.0292968750000), SampleType( 0.0109863281250) },
+        { SampleType(-0.0083007812500), SampleType(-0.0189208984375), SampleType(-0.0291748046875), SampleType( 0.0017089843750) }
+    }};
+    
+    /** Pushes a sample into a channel's detector history and returns the larger of the
+        sample peak and the inter-sample peaks after it, truePeakDelay samples late. */
+    SampleType detectPeak(int channel, SampleType input)
+    {
+        // Each history is stored twice in a row so the taps can be read contiguously
+        auto* history = peakHistory.data() + channel * truePeakTaps * 2;
+        history[historyIndex] = input;
+        history[historyIndex + truePeakTaps] = input;
+        
+        const auto* taps = history + historyIndex + 1;
+        auto sum = PeakLanes::expand(SampleType{0});
+        
+        for (size_t tap = 0; tap < truePeakTaps; ++tap)
+            sum = sum + PeakLanes::load(truePeakCoefficients[tap].data()) * PeakLanes::expand(taps[tap]);
+        
+        alignas(16) std::array<SampleType, 4> values;
+        sum.store(values.data());
+        
+        return juce::jmax(std::abs(taps[truePeakDelay - 1]),
+                          juce::jmax(std::abs(values[0]), std::abs(values[1]), std::abs(values[2]), std::abs(values[3])));
+    }
+    
+    /** Turns the gain each sample requires into the smoothed gain to apply. */
+    SampleType computeGain(SampleType requiredGain)
+    {
+        const auto capacity = holdValues.size();
+        auto wrap = [capacity](size_t index) { return index >= capacity ? index - capacity : index; };
+        
+        // Entries no smaller than the new one can never be the window minimum again
+        while (holdCount > 0 && holdValues[wrap(holdFront + holdCount - 1)] >= requiredGain)
+            --holdCount;
+        
+        auto back = wrap(holdFront + holdCount);
+        holdValues[back] = requiredGain;
+        holdTimes[back] = sampleCounter;
+        ++holdCount;
+        
+        // The window covers this sample and the holdLength before it
+        if (sampleCounter - holdTimes[holdFront] > static_cast<uint32_t>(holdLength))
+        {
+            holdFront = wrap(holdFront + 1);
+            --holdCount;
+        }
+        
+        ++sampleCounter;
+        
+        // Gain drops instantly to the held minimum and recovers with the release time
+        auto heldGain = holdValues[holdFront];
+        releasedGain = heldGain < releasedGain ? heldGain : releasedGain + releaseCoeff * (heldGain - releasedGain);
+        
+        // Averaging over the lookahead window ramps the gain down ahead of each peak
+        averageSum += releasedGain - averageValues[static_cast<size_t>(averageIndex)];
+        averageValues[static_cast<size_t>(averageIndex)] = releasedGain;
+        
+        // Re-sum once per window so the running sum cannot drift
+        if (++averageIndex == lookaheadSamples)
+        {
+            averageIndex = 0;
+            averageSum = std::accumulate(averageValues.begin(), averageValues.end(), SampleType{0});
+        }
+        
+        return averageSum * averageScale;
+    }
+    
+    void resetGain()
+    {
+        std::fill(averageValues.begin(), averageValues.end(), SampleType{1});
+        averageSum = static_cast<SampleType>(lookaheadSamples);
+        averageIndex = 0;
+        releasedGain = SampleType{1};
+        holdFront = 0;
+        holdCount = 0;
+        sampleCounter = 0;
+    }
+    
+    double sampleRate = 44100.0;
+    double lookaheadMs = 1.5;
+    double releaseMs = 50.0;
+    int numChannels = 0;
+    int lookaheadSamples = 1;
+    int holdLength = 1;
+    int delayLength = 1;
+    bool enabled = true;
+    
+    // Ceiling of -0.3 dBTP leaves headroom for lossy codecs
+    SampleType ceiling = static_cast<SampleType>(0.9660508789898133);
+    SampleType releaseCoeff = SampleType{1};
+    
+    Utils::StateArena ownedState;
+    
+    // Delayed audio, one ring of delayLength per channel
+    std::span<SampleType> delayLines;
+    int delayIndex = 0;
+    
+    // True-peak detector
+    std::span<SampleType> peakHistory;
+    int historyIndex = 0;
+    
+    // Sliding minimum of the required gain
+    std::span<SampleType> holdValues;
+    std::span<uint32_t> holdTimes;
+    size_t holdFront = 0;
+    size_t holdCount = 0;
+    uint32_t sampleCounter = 0;
+    
+    // Release and attack smoothing
+    std::span<SampleType> averageValues;
+    SampleType averageSum = SampleType{1};
+    SampleType averageScale = SampleType{1};
+    SampleType releasedGain = SampleType{1};
+    int averageIndex = 0;
+};
+
 /**
  * Simple Brick Wall Limiter.
  * Hard limiting at a specified ceiling.
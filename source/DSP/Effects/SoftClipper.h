@@ -0,0 +1,201 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include "../Utils/DSPUtils.h"
+#include "../Utils/StateArena.h"
+#include <cmath>
+#include <memory>
+#include <span>
+
+namespace DSP {
+namespace Effects {
+
+/**
+ * Anti-aliased soft clipper.
+ * The tanh curve runs at 2x, 4x or 8x the host rate inside a cascade of
+ * polyphase half-band filters, so the harmonics it generates above the host
+ * Nyquist are filtered out instead of folding back into the audible band.
+ *
+ * The half-band filters are either minimum phase (polyphase IIR allpass, low
+ * latency) or linear phase (equiripple FIR). The latency is rounded to whole
+ * samples and stays constant while the clipper is bypassed: the dry signal then
+ * runs through a plain delay and the oversampling filters are skipped entirely.
+ */
+template<typename SampleType>
+class OversampledSoftClipper
+{
+public:
+    enum class FilterType
+    {
+        minimumPhase,
+        linearPhase
+    };
+
+    OversampledSoftClipper() = default;
+
+    /** Sets the oversampling factor as a power of two (1 = 2x, 2 = 4x, 3 = 8x) and
+        the filter type. This changes the latency, so it takes effect on the next prepare(). */
+    void setOversampling(int newFactorLog2, FilterType newFilterType)
+    {
+        oversamplingFactorLog2 = juce::jlimit(1, 3, newFactorLog2);
+        filterType = newFilterType;
+    }
+
+    /** Prepares the oversampling filters and the bypass delay. */
+    void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        ownedState.build([&](Utils::StateArena& arena) { prepare(spec, arena); });
+    }
+
+    /** Prepares the clipper, taking the bypass delay from arena (see StateArena::build).
+        The oversampling filters keep their own JUCE-managed memory. */
+    void prepare(const juce::dsp::ProcessSpec& spec, Utils::StateArena& arena)
+    {
+        numChannels = static_cast<int>(spec.numChannels);
+
+        oversampling = std::make_unique<juce::dsp::Oversampling<SampleType>>(
+            spec.numChannels,
+            static_cast<size_t>(oversamplingFactorLog2),
+            filterType == FilterType::linearPhase ? juce::dsp::Oversampling<SampleType>::filterHalfBandFIREquiripple
+                                                  : juce::dsp::Oversampling<SampleType>::filterHalfBandPolyphaseIIR,
+            true,  // Maximum quality
+            true); // Integer latency, so the bypass delay can match it exactly
+
+        oversampling->initProcessing(spec.maximumBlockSize);
+        latencySamples = juce::roundToInt(oversampling->getLatencyInSamples());
+
+        bypassDelay = arena.allocate<SampleType>(static_cast<size_t>(numChannels * juce::jmax(1, latencySamples)));
+
+        reset();
+    }
+
+    /** Engages or bypasses the clipper. The latency is the same either way. */
+    void setEnabled(bool shouldBeEnabled)
+    {
+        // The filters were idle while bypassed, so start them from silence
+        if (shouldBeEnabled && !enabled && oversampling != nullptr)
+            oversampling->reset();
+
+        enabled = shouldBeEnabled;
+    }
+
+    /** Returns true while the clipper is engaged. */
+    bool isEnabled() const { return enabled; }
+
+    /** Returns the delay added to the signal, in samples. */
+    int getLatencySamples() const
+    {
+        return latencySamples;
+    }
+
+    /** Processes numSamples samples of each channel in place. */
+    void process(SampleType* const* channels, int numChannelsToProcess, int numSamples)
+    {
+        jassert(oversampling != nullptr && numChannelsToProcess <= numChannels);
+        numChannelsToProcess = juce::jmin(numChannelsToProcess, numChannels);
+
+        // The bypass delay always sees the input, so bypassing never outputs stale audio
+        processBypassDelay(channels, numChannelsToProcess, numSamples, !enabled);
+
+        if (!enabled)
+            return;
+
+        juce::dsp::AudioBlock<SampleType> block(channels, static_cast<size_t>(numChannelsToProcess), static_cast<size_t>(numSamples));
+        auto oversampledBlock = oversampling->processSamplesUp(block);
+
+        for (size_t channel = 0; channel < oversampledBlock.getNumChannels(); ++channel)
+        {
+            auto* samples = oversampledBlock.getChannelPointer(channel);
+            Utils::DSPUtils::fastTanh(samples, samples, static_cast<int>(oversampledBlock.getNumSamples()));
+        }
+
+        oversampling->processSamplesDown(block);
+    }
+
+    /** Processes a buffer. */
+    void processBlock(juce::AudioBuffer<SampleType>& buffer)
+    {
+        process(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), buffer.getNumSamples());
+    }
+
+    /** Resets the filter and delay state. */
+    void reset()
+    {
+        if (oversampling != nullptr)
+            oversampling->reset();
+
+        std::fill(bypassDelay.begin(), bypassDelay.end(), SampleType{0});
+        bypassIndex = 0;
+    }
+
+    /** The clipper's running state apart from the bypass delay, which lives in its
+        StateArena. The JUCE oversampling filters can't be captured, so restoring a
+        state while the clipper is engaged restarts them from silence. */
+    struct State
+    {
+        bool enabled;
+        int bypassIndex;
+    };
+
+    /** Returns the running state, see State. */
+    State getState() const
+    {
+        return { enabled, bypassIndex };
+    }
+
+    /** Restores a state returned by getState(). */
+    void setState(const State& state)
+    {
+        if (state.enabled && oversampling != nullptr)
+            oversampling->reset();
+
+        enabled = state.enabled;
+        bypassIndex = state.bypassIndex;
+    }
+
+private:
+    /** Pushes the input through the bypass delay, replacing it with the delayed
+        signal only when writeOutput is set. */
+    void processBypassDelay(SampleType* const* channels, int numChannelsToProcess, int numSamples, bool writeOutput)
+    {
+        if (latencySamples == 0)
+            return;
+
+        for (int channel = 0; channel < numChannelsToProcess; ++channel)
+        {
+            auto* delayLine = bypassDelay.data() + channel * latencySamples;
+            auto* samples = channels[channel];
+            auto index = bypassIndex;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto delayed = delayLine[index];
+                delayLine[index] = samples[i];
+
+                if (writeOutput)
+                    samples[i] = delayed;
+
+                if (++index == latencySamples)
+                    index = 0;
+            }
+        }
+
+        bypassIndex = (bypassIndex + numSamples) % latencySamples;
+    }
+
+    std::unique_ptr<juce::dsp::Oversampling<SampleType>> oversampling;
+    int oversamplingFactorLog2 = 2;
+    FilterType filterType = FilterType::minimumPhase;
+    int numChannels = 0;
+    int latencySamples = 0;
+    bool enabled = false;
+
+    // Keeps the dry signal time-aligned with the oversampled path while bypassed
+    Utils::StateArena ownedState;
+    std::span<SampleType> bypassDelay;
+    int bypassIndex = 0;
+};
+
+} // namespace Effects
+} // namespace DSP
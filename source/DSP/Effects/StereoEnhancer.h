@@ -2,7 +2,10 @@
 
 #include "../Utils/ParameterSmoother.h"
 #include "../Filters/SimpleFilter.h"
+#include "../Filters/LinkwitzRileyCrossover.h"
+#include "../Utils/DSPUtils.h"
 #include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
 
 namespace DSP {
 namespace Effects {
@@ -10,11 +13,17 @@ namespace Effects {
 /**
  * A stereo enhancer that widens the stereo image through phase manipulation,
  * mid-side processing, and frequency-dependent stereo enhancement.
+ *
+ * In multiband mode the side signal is also split by a Linkwitz-Riley crossover
+ * bank and each band gets its own width, on top of the overall width.
  */
 template<typename SampleType>
 class StereoEnhancer
 {
 public:
+    /** Number of bands in multiband width mode. */
+    static constexpr size_t numWidthBands = Filters::LinkwitzRileyCrossoverBank<SampleType>::numBands;
+    
     StereoEnhancer() = default;
     
     /** Prepares the enhancer with sample rate and block size. */
@@ -50,6 +59,16 @@ public:
         lowCutSmoother.snapToTargetValue();
         highCutSmoother.snapToTargetValue();
         
+        // Prepare the multiband width stage
+        crossover.prepare(sampleRate);
+        
+        for (auto& smoother : bandWidthSmoothers)
+        {
+            smoother.prepare(sampleRate, 20.0); // 20ms smoothing
+            smoother.setTargetValue(SampleType{100.0});
+            smoother.snapToTargetValue();
+        }
+        
         reset();
     }
     
@@ -77,68 +96,79 @@ public:
         highCutSmoother.setTargetValue(juce::jlimit(SampleType{0}, SampleType{100}, highCutPercent));
     }
     
+    /** Enables or disables multiband width. While disabled the crossover bank does not run. */
+    void setMultibandEnabled(bool shouldBeEnabled)
+    {
+        // The crossover was idle while disabled, so start it from silence
+        if (shouldBeEnabled && !multibandEnabled)
+            crossover.reset();
+        
+        multibandEnabled = shouldBeEnabled;
+    }
+    
+    /** Returns true while multiband width is enabled. */
+    bool isMultibandEnabled() const { return multibandEnabled; }
+    
+    /** Sets the width of one band (0-200%), lowest band first. */
+    void setBandWidth(size_t band, SampleType widthPercent)
+    {
+        jassert(band < numWidthBands);
+        bandWidthSmoothers[band].setTargetValue(juce::jlimit(SampleType{0}, SampleType{200}, widthPercent));
+    }
+    
+    /** Sets the crossover frequencies between the bands in Hz, in ascending order. */
+    void setCrossoverFrequencies(const std::array<SampleType, numWidthBands - 1>& frequencies)
+    {
+        crossover.setCrossoverFrequencies(frequencies);
+    }
+    
     /** Processes a stereo buffer. */
     void processBlock(juce::AudioBuffer<SampleType>& buffer)
     {
         jassert(buffer.getNumChannels() >= 2);
         
-        auto numSamples = buffer.getNumSamples();
-        
-        for (int i = 0; i < numSamples; ++i)
+        processBlock(buffer.getWritePointer(0), buffer.getWritePointer(1), buffer.getNumSamples());
+    }
+    
+    /** Processes a pair of stereo channels in place.
+        Parameters and filter coefficients are updated once per control block, and only
+        while a smoother is still moving; gains are ramped linearly across each block. */
+    void processBlock(SampleType* left, SampleType* right, int numSamples)
+    {
+        for (int startSample = 0; startSample < numSamples; startSample += controlBlockSize)
         {
-            updateParameters();
-            
-            // Get current sample values
-            auto leftSample = buffer.getSample(0, i);
-            auto rightSample = buffer.getSample(1, i);
-            
-            // Calculate mid and side signals
-            auto midSignal = (leftSample + rightSample) * SampleType{0.5};
-            auto sideSignal = (leftSample - rightSample) * SampleType{0.5};
-            
-            // Apply low and high cut filters to side signal
-            sideSignal = lowCutFilter.processSample(sideSignal);
-            sideSignal = highCutFilter.processSample(sideSignal);
-            
-            // Apply width control to side signal
-            sideSignal *= currentWidthGain;
-            
-            // Apply brightness enhancement to side signal
-            if (currentBrightness != SampleType{0.0})
-            {
-                auto brightnessFactor = juce::Decibels::decibelsToGain(static_cast<float>(currentBrightness));
-                auto highFreqContent = brightnessFilter.processSample(sideSignal);
-                sideSignal += highFreqContent * (brightnessFactor - SampleType{1.0});
-            }
-            
-            // Convert back to left/right
-            auto newLeft = midSignal + sideSignal;
-            auto newRight = midSignal - sideSignal;
-            
-            buffer.setSample(0, i, newLeft);
-            buffer.setSample(1, i, newRight);
+            processControlBlock(left + startSample, right + startSample,
+                                juce::jmin(controlBlockSize, numSamples - startSample));
         }
     }
     
-    /** Resets the stereo enhancer state. */
+    /** Resets the stereo enhancer state. The settings are kept, with the smoothers
+        landed on them. */
     void reset()
     {
         lowCutFilter.reset();
         highCutFilter.reset();
         brightnessFilter.reset();
+        crossover.reset();
+        
+        widthSmoother.snapToTargetValue();
+        brightnessSmoother.snapToTargetValue();
+        lowCutSmoother.snapToTargetValue();
+        highCutSmoother.snapToTargetValue();
         
-        widthSmoother.reset(SampleType{100.0});
-        brightnessSmoother.reset(SampleType{0.0});
-        lowCutSmoother.reset(SampleType{0.0});
-        highCutSmoother.reset(SampleType{0.0});
+        for (auto& smoother : bandWidthSmoothers)
+            smoother.snapToTargetValue();
         
         currentWidthGain = SampleType{1.0};
-        currentBrightness = SampleType{0.0};
-        currentLowCut = SampleType{0.0};
-        currentHighCut = SampleType{0.0};
+        currentBrightnessGain = SampleType{1.0};
+        currentBandGains.fill(SampleType{1.0});
+        parametersNeedUpdate = true;
     }
 
 private:
+    /** Number of samples between parameter and coefficient updates. */
+    static constexpr int controlBlockSize = 32;
+    
     double sampleRate = 44100.0;
     
     // Filters
@@ -151,32 +181,166 @@ private:
     Utils::ParameterSmoother<SampleType> brightnessSmoother;
     Utils::ParameterSmoother<SampleType> lowCutSmoother;
     Utils::ParameterSmoother<SampleType> highCutSmoother;
+    std::array<Utils::ParameterSmoother<SampleType>, numWidthBands> bandWidthSmoothers;
     
-    // Current parameter values
+    // Current parameter values, as reached at the end of the last control block
     SampleType currentWidthGain = SampleType{1.0};
-    SampleType currentBrightness = SampleType{0.0};
-    SampleType currentLowCut = SampleType{0.0};
-    SampleType currentHighCut = SampleType{0.0};
+    SampleType currentBrightnessGain = SampleType{1.0};
+    alignas(16) std::array<SampleType, numWidthBands> currentBandGains {};
+    bool parametersNeedUpdate = true;
+    
+    // Multiband width
+    Filters::LinkwitzRileyCrossoverBank<SampleType> crossover;
+    bool multibandEnabled = false;
+    
+    // High frequency content of the side signal for the brightness stage
+    std::array<SampleType, controlBlockSize> brightnessScratch {};
     
-    void updateParameters()
+    // Side signal split into bands, one interleaved frame of numWidthBands per sample
+    alignas(64) std::array<SampleType, controlBlockSize * numWidthBands> bandFrames {};
+    
+    void processControlBlock(SampleType* left, SampleType* right, int numSamples)
     {
+        // Gains ramp from where the previous block ended
+        const bool forcedUpdate = parametersNeedUpdate;
+        auto widthGain = currentWidthGain;
+        auto brightnessGain = currentBrightnessGain;
+        auto bandGains = currentBandGains;
+        
+        updateParameters(numSamples);
+        
+        // Values forced after a reset apply at once instead of ramping
+        if (forcedUpdate)
+        {
+            widthGain = currentWidthGain;
+            brightnessGain = currentBrightnessGain;
+            bandGains = currentBandGains;
+        }
+        
+        const auto blockLength = static_cast<SampleType>(numSamples);
+        const auto widthGainStep = (currentWidthGain - widthGain) / blockLength;
+        const auto brightnessGainStep = (currentBrightnessGain - brightnessGain) / blockLength;
+        const bool brightnessActive = brightnessGain != SampleType{1.0} || currentBrightnessGain != SampleType{1.0};
+        
+        // Mid/side matrix in place: left holds the mid signal and right the side signal
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto leftSample = left[i];
+            const auto rightSample = right[i];
+            left[i] = (leftSample + rightSample) * SampleType{0.5};
+            right[i] = (leftSample - rightSample) * SampleType{0.5};
+        }
+        
+        // The low and high cut filters and the width gain shape the side signal. The
+        // filters are recursive, so this pass runs sample by sample
+        for (int i = 0; i < numSamples; ++i)
+        {
+            widthGain += widthGainStep;
+            right[i] = highCutFilter.processSample(lowCutFilter.processSample(right[i])) * widthGain;
+        }
+        
+        if (multibandEnabled)
+            processMultibandWidth(right, numSamples, bandGains);
+        
+        // Brightness enhancement adds the boosted high frequency content of the side signal
+        if (brightnessActive)
+        {
+            for (int i = 0; i < numSamples; ++i)
+                brightnessScratch[static_cast<size_t>(i)] = brightnessFilter.processSample(right[i]);
+            
+            auto brightnessAmount = brightnessGain - SampleType{1.0};
+            
+            for (int i = 0; i < numSamples; ++i)
+            {
+                brightnessAmount += brightnessGainStep;
+                right[i] += brightnessScratch[static_cast<size_t>(i)] * brightnessAmount;
+            }
+        }
+        
+        // Convert back to left/right
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto midSignal = left[i];
+            const auto sideSignal = right[i];
+            left[i] = midSignal + sideSignal;
+            right[i] = midSignal - sideSignal;
+        }
+        
+        lowCutFilter.snapToZero();
+        highCutFilter.snapToZero();
+        brightnessFilter.snapToZero();
+    }
+    
+    /** Splits the side signal into bands, all bands at once as SIMD lanes, and sums them
+        back with their band gains ramped from startGains to the current gains. */
+    void processMultibandWidth(SampleType* side, int numSamples, const std::array<SampleType, numWidthBands>& startGains)
+    {
+        using BandLanes = Utils::LaneVector<SampleType, numWidthBands>;
+        
+        auto* frames = bandFrames.data();
+        
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto* frame = frames + static_cast<size_t>(i) * numWidthBands;
+            
+            for (size_t band = 0; band < numWidthBands; ++band)
+                frame[band] = side[i];
+        }
+        
+        crossover.processFrames(frames, numSamples);
+        
+        auto gains = BandLanes::load(startGains.data());
+        const auto gainStep = (BandLanes::load(currentBandGains.data()) - gains)
+                            * BandLanes::expand(SampleType{1} / static_cast<SampleType>(numSamples));
+        
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto* frame = frames + static_cast<size_t>(i) * numWidthBands;
+            
+            gains = gains + gainStep;
+            (BandLanes::load(frame) * gains).store(frame);
+            
+            auto sum = SampleType{0};
+            
+            for (size_t band = 0; band < numWidthBands; ++band)
+                sum += frame[band];
+            
+            side[i] = sum;
+        }
+    }
+    
+    /** Advances the smoothers by one control block and recomputes the gains and filter
+        coefficients of those still moving. Settled parameters cost nothing. */
+    void updateParameters(int numSamples)
+    {
+        const bool forceUpdate = parametersNeedUpdate;
+        parametersNeedUpdate = false;
+        
         // Update width (convert percentage to gain)
-        auto widthPercent = widthSmoother.getNextValue();
-        currentWidthGain = widthPercent / SampleType{100.0};
+        if (forceUpdate || widthSmoother.isSmoothing())
+            currentWidthGain = widthSmoother.skip(numSamples) / SampleType{100.0};
         
         // Update brightness
-        currentBrightness = brightnessSmoother.getNextValue();
+        if (forceUpdate || brightnessSmoother.isSmoothing())
+            currentBrightnessGain = Utils::DSPUtils::fastDbToGain(brightnessSmoother.skip(numSamples));
         
         // Update filter cutoffs
-        currentLowCut = lowCutSmoother.getNextValue();
-        currentHighCut = highCutSmoother.getNextValue();
+        if (forceUpdate || lowCutSmoother.isSmoothing())
+            lowCutFilter.setCutoffPercentage(lowCutSmoother.skip(numSamples));
+        
+        if (forceUpdate || highCutSmoother.isSmoothing())
+            highCutFilter.setCutoffPercentage(highCutSmoother.skip(numSamples));
         
-        // Update filter parameters
-        lowCutFilter.setCutoffPercentage(currentLowCut);
-        highCutFilter.setCutoffPercentage(currentHighCut);
+        // Update band widths
+        for (size_t band = 0; band < numWidthBands; ++band)
+        {
+            if (forceUpdate || bandWidthSmoothers[band].isSmoothing())
+                currentBandGains[band] = bandWidthSmoothers[band].skip(numSamples) / SampleType{100.0};
+        }
         
         // Set brightness filter to a high frequency for enhancement
-        brightnessFilter.setCutoffFrequency(SampleType{3000.0});
+        if (forceUpdate)
+            brightnessFilter.setCutoffFrequency(SampleType{3000.0});
     }
 };
 
@@ -1,7 +1,12 @@
 #pragma once
 
+#include "../Utils/DSPUtils.h"
+#include "../Utils/SIMDLanes.h"
+#include "../Utils/StateArena.h"
 #include <juce_audio_basics/juce_audio_basics.h>
-#include <vector>
+#include <array>
+#include <cstdint>
+#include <span>
 
 namespace DSP {
 namespace Filters {
@@ -9,29 +14,73 @@ namespace Filters {
 /**
  * A single allpass filter with adjustable delay and feedback.
  * Forms the building block for Schroeder reverb networks.
+ *
+ * NumLanes channels share one interleaved delay line and are processed together
+ * as a frame: the read position and interpolation are computed once per frame,
+ * and the per-lane arithmetic maps onto a single SIMD register (see LaneVector).
+ *
+ * The delay line is a power-of-two ring indexed with a bitmask, and the read
+ * position is a fixed-point phase that advances incrementally while the delay
+ * time ramps, so the per-sample path has no modulo, floor or double arithmetic.
+ *
+ * Values written back into the delay line are flushed to zero once they decay
+ * below 1e-30, so the feedback loop never recirculates denormals, even when the
+ * caller has not enabled flush-to-zero.
+ *
+ * The delay line lives in a StateArena: the filter's own when prepared on its
+ * own, or one shared with the rest of a processor's components.
  */
-template<typename SampleType>
+template<typename SampleType, size_t NumLanes = 1>
 class AllpassFilter
 {
 public:
+    static_assert(NumLanes >= 1, "AllpassFilter needs at least one lane");
+    
+    /** Number of channels processed together in one interleaved frame. */
+    static constexpr size_t numLanes = NumLanes;
+    
     AllpassFilter() = default;
     
     /** Prepares the filter with sample rate and maximum delay time. */
     void prepare(double newSampleRate, double maxDelayMs)
+    {
+        ownedState.build([&](Utils::StateArena& arena) { prepare(newSampleRate, maxDelayMs, arena); });
+    }
+    
+    /** Prepares the filter, taking its delay line from arena (see StateArena::build). */
+    void prepare(double newSampleRate, double maxDelayMs, Utils::StateArena& arena)
     {
         _sampleRate = newSampleRate;
         
-        auto maxDelaySamples = static_cast<size_t>(maxDelayMs * 0.001 * _sampleRate) + 1;
-        delayLine.resize(maxDelaySamples, SampleType{0});
+        // Capacity is rounded up to a power of two so indices wrap with a mask
+        maxDelaySamples = juce::jmax(1.0, maxDelayMs * 0.001 * _sampleRate);
+        auto capacity = static_cast<size_t>(juce::nextPowerOfTwo(static_cast<int>(maxDelaySamples) + 2));
+        
+        mask = capacity - 1;
+        delayLine = arena.allocate<SampleType>(capacity * NumLanes);
         
         reset();
     }
     
-    /** Sets the delay time in milliseconds. */
-    void setDelayTime(double delayMs)
+    /** Sets the delay time in milliseconds.
+        With rampSamples > 0 the read position glides linearly to the new delay
+        over that many samples, otherwise it jumps immediately. */
+    void setDelayTime(double delayMs, int rampSamples = 0)
     {
-        auto newDelaySamples = static_cast<double>(delayMs * 0.001 * _sampleRate);
-        this->delaySamples = juce::jlimit(1.0, static_cast<double>(delayLine.size() - 1), newDelaySamples);
+        auto newDelaySamples = juce::jlimit(1.0, maxDelaySamples, delayMs * 0.001 * _sampleRate);
+        targetDelay = static_cast<uint64_t>(newDelaySamples * static_cast<double>(phaseOne));
+        
+        if (rampSamples <= 0)
+        {
+            rampSamplesRemaining = 0;
+            finishDelayRamp();
+            return;
+        }
+        
+        // The read phase advances by (1 - step) per sample while the delay ramps
+        auto step = (static_cast<int64_t>(targetDelay) - static_cast<int64_t>(getCurrentDelay())) / rampSamples;
+        readIncrement = phaseOne - static_cast<uint64_t>(step);
+        rampSamplesRemaining = rampSamples;
     }
     
     /** Sets the feedback coefficient (-1.0 to 1.0). */
@@ -42,21 +91,64 @@ public:
     
     /** Processes a single sample. */
     SampleType processSample(SampleType input)
+        requires (NumLanes == 1)
     {
-        // Get delayed sample with interpolation
-        auto delayedSample = getInterpolatedSample();
-        
-        // Allpass equation: y[n] = -g*x[n] + x[n-d] + g*y[n-d]
-        auto output = -feedback * input + delayedSample;
-        
-        // Store input + feedback into delay line
-        auto feedbackInput = input + feedback * delayedSample;
-        delayLine[writeIndex] = feedbackInput;
-        
-        // Advance write index
-        writeIndex = (writeIndex + 1) % delayLine.size();
+        processFrame(&input);
+        return input;
+    }
+    
+    /** Processes one interleaved frame of NumLanes samples in place. */
+    void processFrame(SampleType* frame)
+    {
+        processFrames(frame, frame, 1);
+        advanceDelayRamp(1);
+    }
+    
+    /** Processes a block of interleaved frames in place (plain samples when NumLanes is 1). */
+    void processBlock(SampleType* frames, int numFramesToProcess)
+    {
+        process(frames, frames, numFramesToProcess);
+    }
+    
+    /** Processes a block of interleaved frames (plain samples when NumLanes is 1).
+        Input and output may point to the same memory.
         
-        return output;
+        Samples read from the delay line are always at least the current integer
+        delay old, so within a chunk shorter than that delay none of the reads
+        depend on samples written in the same chunk. Each chunk is therefore
+        evaluated as a gather pass followed by a flat vectorisable pass instead
+        of the serial per-sample recurrence. */
+    void process(const SampleType* input, SampleType* output, int numFramesToProcess)
+    {
+        while (numFramesToProcess > 0)
+        {
+            // Split at the end of a delay ramp so the inner loops have a constant increment
+            auto numFrames = rampSamplesRemaining > 0 ? juce::jmin(numFramesToProcess, rampSamplesRemaining)
+                                                      : numFramesToProcess;
+            
+            // While ramping, the delay moves monotonically between current and target
+            auto minimumDelay = static_cast<int>(juce::jmin(getCurrentDelay(), targetDelay) >> phaseFractionBits);
+            auto maxChunkFrames = juce::jmin(minimumDelay - 1, maxChunkLength);
+            
+            if (maxChunkFrames < 2)
+            {
+                processFrames(input, output, numFrames);
+            }
+            else
+            {
+                for (int start = 0; start < numFrames; start += maxChunkFrames)
+                {
+                    auto offset = static_cast<size_t>(start) * NumLanes;
+                    processChunk(input + offset, output + offset, juce::jmin(maxChunkFrames, numFrames - start));
+                }
+            }
+            
+            advanceDelayRamp(numFrames);
+            
+            input += static_cast<size_t>(numFrames) * NumLanes;
+            output += static_cast<size_t>(numFrames) * NumLanes;
+            numFramesToProcess -= numFrames;
+        }
     }
     
     /** Resets the filter state. */
@@ -65,29 +157,197 @@ public:
         std::fill(delayLine.begin(), delayLine.end(), SampleType{0});
         writeIndex = 0;
         feedback = SampleType{0};
-        delaySamples = 1.0;
+        targetDelay = phaseOne;
+        rampSamplesRemaining = 0;
+        finishDelayRamp();
+    }
+    
+    /** The filter's running state apart from the delay line contents, which live in
+        its StateArena. Only valid for filters prepared with the same settings. */
+    struct State
+    {
+        size_t writeIndex;
+        SampleType feedback;
+        uint64_t readPhase;
+        uint64_t readIncrement;
+        uint64_t targetDelay;
+        int rampSamplesRemaining;
+    };
+    
+    /** Returns the running state, see State. */
+    State getState() const
+    {
+        return { writeIndex, feedback, readPhase, readIncrement, targetDelay, rampSamplesRemaining };
+    }
+    
+    /** Restores a state returned by getState(). */
+    void setState(const State& state)
+    {
+        writeIndex = state.writeIndex;
+        feedback = state.feedback;
+        readPhase = state.readPhase;
+        readIncrement = state.readIncrement;
+        targetDelay = state.targetDelay;
+        rampSamplesRemaining = state.rampSamplesRemaining;
     }
 
 private:
-    std::vector<SampleType> delayLine;
+    using Lanes = Utils::LaneVector<SampleType, NumLanes>;
+    
+    // Read positions are 32.32 fixed point, in samples
+    static constexpr int phaseFractionBits = 32;
+    static constexpr uint64_t phaseOne = uint64_t{1} << phaseFractionBits;
+    static constexpr uint64_t phaseFractionMask = phaseOne - 1;
+    
+    // Longest chunk evaluated in one vectorised pass by process()
+    static constexpr int maxChunkLength = 64;
+    
+    Utils::StateArena ownedState;
+    std::span<SampleType> delayLine;
+    size_t mask = 0;
     size_t writeIndex = 0;
     double _sampleRate = 44100.0;
-    double delaySamples = 1.0;
+    double maxDelaySamples = 1.0;
     SampleType feedback = SampleType{0};
     
-    SampleType getInterpolatedSample() const
+    uint64_t readPhase = 0;
+    uint64_t readIncrement = phaseOne;
+    uint64_t targetDelay = phaseOne;
+    int rampSamplesRemaining = 0;
+    
+    /** Processes frames one at a time with a constant read increment. */
+    void processFrames(const SampleType* input, SampleType* output, int numFrames)
     {
-        auto readPosition = static_cast<double>(writeIndex) - delaySamples;
-        if (readPosition < 0.0)
-            readPosition += static_cast<double>(delayLine.size());
+        const auto gain = Lanes::expand(feedback);
+        auto* delayData = delayLine.data();
+        
+        for (int i = 0; i < numFrames; ++i)
+        {
+            auto offset = static_cast<size_t>(i) * NumLanes;
+            
+            // Get delayed frame with interpolation
+            auto delayedFrame = readInterpolatedFrame();
+            auto inputFrame = Lanes::load(input + offset);
+            
+            // Allpass equation: y[n] = -g*x[n] + x[n-d] + g*y[n-d]
+            (delayedFrame - gain * inputFrame).store(output + offset);
+            
+            // Store input + feedback into delay line
+            auto* writeFrame = delayData + writeIndex * NumLanes;
+            (inputFrame + gain * delayedFrame).store(writeFrame);
             
-        auto readIndex1 = static_cast<size_t>(readPosition) % delayLine.size();
-        auto readIndex2 = (readIndex1 + 1) % delayLine.size();
+            for (size_t lane = 0; lane < NumLanes; ++lane)
+                writeFrame[lane] = Utils::DSPUtils::flushDenormalToZero(writeFrame[lane]);
+            
+            // Advance write index and read phase
+            writeIndex = (writeIndex + 1) & mask;
+            readPhase += readIncrement;
+        }
+    }
+    
+    /** Processes a chunk no longer than the current delay as one gather pass and one
+        flat pass over the chunk's samples. */
+    void processChunk(const SampleType* input, SampleType* output, int numFrames)
+    {
+        jassert(numFrames <= maxChunkLength);
+        
+        std::array<SampleType, static_cast<size_t>(maxChunkLength) * NumLanes> delayed;
+        auto* delayData = delayLine.data();
+        auto capacity = mask + 1;
+        auto numValues = static_cast<size_t>(numFrames) * NumLanes;
+        auto readIndex = static_cast<size_t>(readPhase >> phaseFractionBits) & mask;
+        
+        // Gather: at a steady delay the fraction is constant and the reads are contiguous
+        if (readIncrement == phaseOne && readIndex + static_cast<size_t>(numFrames) < capacity)
+        {
+            const auto fraction = getReadFraction();
+            const auto* frame1 = delayData + readIndex * NumLanes;
+            const auto* frame2 = frame1 + NumLanes;
+            
+            for (size_t i = 0; i < numValues; ++i)
+                delayed[i] = frame1[i] + fraction * (frame2[i] - frame1[i]);
+            
+            readPhase += static_cast<uint64_t>(numFrames) * phaseOne;
+        }
+        else
+        {
+            for (size_t i = 0; i < numValues; i += NumLanes)
+            {
+                readInterpolatedFrame().store(delayed.data() + i);
+                readPhase += readIncrement;
+            }
+        }
+        
+        // Allpass equation and delay line writes over the whole chunk
+        const auto gain = feedback;
+        
+        if (writeIndex + static_cast<size_t>(numFrames) <= capacity)
+        {
+            auto* writeData = delayData + writeIndex * NumLanes;
+            
+            for (size_t i = 0; i < numValues; ++i)
+            {
+                auto x = input[i];
+                output[i] = delayed[i] - gain * x;
+                writeData[i] = Utils::DSPUtils::flushDenormalToZero(x + gain * delayed[i]);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < numValues; ++i)
+            {
+                auto x = input[i];
+                output[i] = delayed[i] - gain * x;
+                delayData[((writeIndex + i / NumLanes) & mask) * NumLanes + i % NumLanes] = Utils::DSPUtils::flushDenormalToZero(x + gain * delayed[i]);
+            }
+        }
+        
+        writeIndex = (writeIndex + static_cast<size_t>(numFrames)) & mask;
+    }
+    
+    SampleType getReadFraction() const
+    {
+        const auto fractionScale = static_cast<SampleType>(1.0 / static_cast<double>(phaseOne));
+        return static_cast<SampleType>(static_cast<int64_t>(readPhase & phaseFractionMask)) * fractionScale;
+    }
+    
+    Lanes readInterpolatedFrame() const
+    {
+        auto readIndex1 = static_cast<size_t>(readPhase >> phaseFractionBits) & mask;
+        auto readIndex2 = (readIndex1 + 1) & mask;
         
-        auto fraction = readPosition - std::floor(readPosition);
+        auto frame1 = Lanes::load(delayLine.data() + readIndex1 * NumLanes);
+        auto frame2 = Lanes::load(delayLine.data() + readIndex2 * NumLanes);
         
-        return static_cast<SampleType>((1.0 - fraction) * delayLine[readIndex1] + 
-                                       fraction * delayLine[readIndex2]);
+        return frame1 + Lanes::expand(getReadFraction()) * (frame2 - frame1);
+    }
+    
+    void advanceDelayRamp(int numFrames)
+    {
+        if (rampSamplesRemaining <= 0)
+            return;
+        
+        rampSamplesRemaining -= numFrames;
+        
+        if (rampSamplesRemaining <= 0)
+        {
+            rampSamplesRemaining = 0;
+            finishDelayRamp();
+        }
+    }
+    
+    /** The distance between write and read position, also valid mid-ramp. */
+    uint64_t getCurrentDelay() const
+    {
+        auto ringMask = (static_cast<uint64_t>(mask) << phaseFractionBits) | phaseFractionMask;
+        return ((static_cast<uint64_t>(writeIndex) << phaseFractionBits) - readPhase) & ringMask;
+    }
+    
+    /** Lands exactly on the target delay, discarding any accumulated ramp rounding. */
+    void finishDelayRamp()
+    {
+        readIncrement = phaseOne;
+        readPhase = (static_cast<uint64_t>(writeIndex) << phaseFractionBits) - targetDelay;
     }
 };
 
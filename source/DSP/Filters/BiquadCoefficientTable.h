@@ -0,0 +1,90 @@
+#pragma once
+
+#include "../Utils/StateArena.h"
+#include <juce_dsp/juce_dsp.h>
+#include <span>
+
+namespace DSP {
+namespace Filters {
+
+/**
+ * A table of second-order IIR coefficients sampled over a parameter range.
+ * The table is built in prepare() (which may allocate), and lookups linearly
+ * interpolate between neighbouring entries, so updating a filter from the audio
+ * thread is a handful of loads and multiply-adds with no allocation.
+ *
+ * Coefficients are stored in JUCE's normalised order: b0, b1, b2, a1, a2.
+ * The table's memory comes from a StateArena, its own or a processor's.
+ */
+template<typename SampleType>
+class BiquadCoefficientTable
+{
+public:
+    static constexpr size_t numCoefficients = 5;
+    
+    BiquadCoefficientTable() = default;
+    
+    /** Builds the table over [minValue, maxValue] with numEntries evenly spaced points.
+        makeCoefficients is called with each parameter value and must return a
+        second-order juce::dsp::IIR::Coefficients pointer. */
+    template<typename CoefficientsFactory>
+    void prepare(SampleType newMinValue, SampleType newMaxValue, size_t numEntries,
+                 CoefficientsFactory&& makeCoefficients)
+    {
+        ownedState.build([&](Utils::StateArena& arena)
+        {
+            prepare(newMinValue, newMaxValue, numEntries, makeCoefficients, arena);
+        });
+    }
+    
+    /** Builds the table, taking its memory from arena (see StateArena::build). */
+    template<typename CoefficientsFactory>
+    void prepare(SampleType newMinValue, SampleType newMaxValue, size_t numEntries,
+                 CoefficientsFactory&& makeCoefficients, Utils::StateArena& arena)
+    {
+        jassert(numEntries >= 2 && newMaxValue > newMinValue);
+        
+        minValue = newMinValue;
+        maxValue = newMaxValue;
+        lastIndex = numEntries - 1;
+        stepsPerUnit = static_cast<SampleType>(lastIndex) / (maxValue - minValue);
+        
+        table = arena.allocate<SampleType>(numEntries * numCoefficients);
+        
+        for (size_t i = 0; i < numEntries; ++i)
+        {
+            auto value = minValue + static_cast<SampleType>(i) / stepsPerUnit;
+            auto coefficients = makeCoefficients(value);
+            
+            jassert(coefficients->getFilterOrder() == 2);
+            std::copy_n(coefficients->getRawCoefficients(), numCoefficients, table.begin() + static_cast<std::ptrdiff_t>(i * numCoefficients));
+        }
+    }
+    
+    /** Writes the interpolated coefficients for a parameter value into destination. */
+    void lookup(SampleType value, SampleType* destination) const
+    {
+        jassert(!table.empty());
+        
+        auto position = (juce::jlimit(minValue, maxValue, value) - minValue) * stepsPerUnit;
+        auto index = juce::jmin(static_cast<size_t>(position), lastIndex - 1);
+        auto fraction = position - static_cast<SampleType>(index);
+        
+        const auto* lower = table.data() + index * numCoefficients;
+        const auto* upper = lower + numCoefficients;
+        
+        for (size_t i = 0; i < numCoefficients; ++i)
+            destination[i] = lower[i] + fraction * (upper[i] - lower[i]);
+    }
+
+private:
+    Utils::StateArena ownedState;
+    std::span<SampleType> table;
+    SampleType minValue = SampleType{0};
+    SampleType maxValue = SampleType{1};
+    SampleType stepsPerUnit = SampleType{1};
+    size_t lastIndex = 1;
+};
+
+} // namespace Filters
+} // namespace DSP
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "BiquadCoefficientTable.h"
+#include "MultiChannelBiquad.h"
 #include <juce_dsp/juce_dsp.h>
 #include <juce_audio_basics/juce_audio_basics.h>
 
@@ -8,8 +10,11 @@ namespace Filters {
 
 /**
  * High-quality EQ section with high shelf filter for brightness control.
+ * Coefficients come from a table built in prepare(), so setBrightness() never allocates.
+ * Each of the NumChannels channels keeps its own filter state, and all channels
+ * are processed together as interleaved frames.
  */
-template<typename SampleType>
+template<typename SampleType, size_t NumChannels = 2>
 class BrightnessEQ
 {
 public:
@@ -17,40 +22,68 @@ public:
     
     /** Prepares the EQ with sample rate. */
     void prepare(const juce::dsp::ProcessSpec& spec)
+    {
+        ownedState.build([&](Utils::StateArena& arena) { prepare(spec, arena); });
+    }
+    
+    /** Prepares the EQ, taking its coefficient table from arena (see StateArena::build). */
+    void prepare(const juce::dsp::ProcessSpec& spec, Utils::StateArena& arena)
     {
         sampleRate = spec.sampleRate;
-        highShelfFilter.prepare(spec);
+        
+        // High shelf filter at 3kHz, tabulated in 0.25 dB steps
+        brightnessTable.prepare(SampleType{-12.0}, SampleType{12.0}, 97, [this](SampleType brightnessDb)
+        {
+            return juce::dsp::IIR::Coefficients<SampleType>::makeHighShelf(
+                sampleRate,
+                SampleType{3000.0}, // 3kHz cutoff
+                SampleType{0.707},  // Q factor
+                juce::Decibels::decibelsToGain(brightnessDb)
+            );
+        }, arena);
+        
+        setBrightness(SampleType{0.0});
         reset();
     }
     
     /** Sets the brightness amount in dB (-12 to +12). */
     void setBrightness(SampleType brightnessDb)
     {
-        brightnessDb = juce::jlimit(SampleType{-12.0}, SampleType{12.0}, brightnessDb);
-        
-        // High shelf filter at 3kHz
-        auto coeffs = juce::dsp::IIR::Coefficients<SampleType>::makeHighShelf(
-            sampleRate, 
-            SampleType{3000.0}, // 3kHz cutoff
-            SampleType{0.707},  // Q factor
-            juce::Decibels::decibelsToGain(brightnessDb)
-        );
-        
-        *highShelfFilter.coefficients = *coeffs;
+        SampleType coefficients[BiquadCoefficientTable<SampleType>::numCoefficients];
+        brightnessTable.lookup(brightnessDb, coefficients);
+        highShelfFilter.setCoefficients(coefficients);
     }
     
     /** Processes a single sample. */
     SampleType processSample(SampleType input)
+        requires (NumChannels == 1)
     {
-        return highShelfFilter.processSample(input);
+        highShelfFilter.processFrames(&input, 1);
+        return input;
+    }
+    
+    /** Processes a block of interleaved frames in place. */
+    void processFrames(SampleType* frames, int numFrames)
+    {
+        highShelfFilter.processFrames(frames, numFrames);
     }
     
     /** Processes a block of samples. */
     void processBlock(juce::AudioBuffer<SampleType>& buffer)
     {
-        juce::dsp::AudioBlock<SampleType> block(buffer);
-        juce::dsp::ProcessContextReplacing<SampleType> context(block);
-        highShelfFilter.process(context);
+        auto numBufferChannels = juce::jmin(static_cast<size_t>(buffer.getNumChannels()), NumChannels);
+        std::array<SampleType, NumChannels> frame {};
+        
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            for (size_t channel = 0; channel < numBufferChannels; ++channel)
+                frame[channel] = buffer.getSample(static_cast<int>(channel), i);
+            
+            highShelfFilter.processFrames(frame.data(), 1);
+            
+            for (size_t channel = 0; channel < numBufferChannels; ++channel)
+                buffer.setSample(static_cast<int>(channel), i, frame[channel]);
+        }
     }
     
     /** Resets the filter state. */
@@ -58,16 +91,30 @@ public:
     {
         highShelfFilter.reset();
     }
+    
+    /** The EQ's running state: the filter's coefficients and history. */
+    using State = MultiChannelBiquad<SampleType, NumChannels>;
+    
+    /** Returns the running state, see State. */
+    State getState() const { return highShelfFilter; }
+    
+    /** Restores a state returned by getState(). */
+    void setState(const State& state) { highShelfFilter = state; }
 
 private:
-    juce::dsp::IIR::Filter<SampleType> highShelfFilter;
+    Utils::StateArena ownedState;
+    MultiChannelBiquad<SampleType, NumChannels> highShelfFilter;
+    BiquadCoefficientTable<SampleType> brightnessTable;
     double sampleRate = 44100.0;
 };
 
 /**
  * Dual filter section for Low Cut and High Cut controls.
+ * Coefficients come from tables built in prepare(), so cut changes never allocate.
+ * Each of the NumChannels channels keeps its own filter state, and all channels
+ * are processed together as interleaved frames.
  */
-template<typename SampleType>
+template<typename SampleType, size_t NumChannels = 2>
 class DualCutFilter
 {
 public:
@@ -76,91 +123,104 @@ public:
     /** Prepares the filters with sample rate. */
     void prepare(const juce::dsp::ProcessSpec& spec)
     {
-        sampleRate = spec.sampleRate;
-        lowCutFilter.prepare(spec);
-        highCutFilter.prepare(spec);
-        reset();
+        ownedState.build([&](Utils::StateArena& arena) { prepare(spec, arena); });
     }
     
-    /** Sets the low cut amount (0-100%). */
-    void setLowCut(SampleType cutAmount)
+    /** Prepares the filters, taking their coefficient tables from arena (see StateArena::build). */
+    void prepare(const juce::dsp::ProcessSpec& spec, Utils::StateArena& arena)
     {
-        cutAmount = juce::jlimit(SampleType{0.0}, SampleType{100.0}, cutAmount);
+        sampleRate = spec.sampleRate;
+        
+        // The ranges reach past Nyquist below 40 kHz, so keep both cutoffs under it
+        const auto maxFrequency = static_cast<SampleType>(0.45 * sampleRate);
         
-        if (cutAmount > SampleType{1.0})
+        // Both cut ranges are tabulated in 0.5% steps
+        lowCutTable.prepare(SampleType{0.0}, SampleType{100.0}, 201, [this, maxFrequency](SampleType cutAmount)
         {
             // Map 0-100% to 20Hz-1000Hz
-            SampleType frequency = SampleType{20.0} + (cutAmount * 0.01f) * SampleType{980.0};
+            SampleType frequency = juce::jmin(maxFrequency, SampleType{20.0} + (cutAmount * SampleType{0.01}) * SampleType{980.0});
             
-            auto coeffs = juce::dsp::IIR::Coefficients<SampleType>::makeHighPass(
+            return juce::dsp::IIR::Coefficients<SampleType>::makeHighPass(
                 sampleRate,
                 frequency,
                 SampleType{0.707} // Butterworth response
             );
-            
-            *lowCutFilter.coefficients = *coeffs;
-            lowCutActive = true;
-        }
-        else
-        {
-            lowCutActive = false;
-        }
-    }
-    
-    /** Sets the high cut amount (0-100%). */
-    void setHighCut(SampleType cutAmount)
-    {
-        cutAmount = juce::jlimit(SampleType{0.0}, SampleType{100.0}, cutAmount);
+        }, arena);
         
-        if (cutAmount > SampleType{1.0})
+        highCutTable.prepare(SampleType{0.0}, SampleType{100.0}, 201, [this, maxFrequency](SampleType cutAmount)
         {
             // Map 0-100% to 20kHz-1kHz (inverted)
-            SampleType frequency = SampleType{20000.0} - (cutAmount * 0.01f) * SampleType{19000.0};
+            SampleType frequency = juce::jmin(maxFrequency, SampleType{20000.0} - (cutAmount * SampleType{0.01}) * SampleType{19000.0});
             
-            auto coeffs = juce::dsp::IIR::Coefficients<SampleType>::makeLowPass(
+            return juce::dsp::IIR::Coefficients<SampleType>::makeLowPass(
                 sampleRate,
                 frequency,
                 SampleType{0.707} // Butterworth response
             );
-            
-            *highCutFilter.coefficients = *coeffs;
-            highCutActive = true;
+        }, arena);
+        
+        reset();
+    }
+    
+    /** Sets the low cut amount (0-100%). */
+    void setLowCut(SampleType cutAmount)
+    {
+        lowCutActive = cutAmount > SampleType{1.0};
+        
+        if (lowCutActive)
+        {
+            SampleType coefficients[BiquadCoefficientTable<SampleType>::numCoefficients];
+            lowCutTable.lookup(cutAmount, coefficients);
+            lowCutFilter.setCoefficients(coefficients);
         }
-        else
+    }
+    
+    /** Sets the high cut amount (0-100%). */
+    void setHighCut(SampleType cutAmount)
+    {
+        highCutActive = cutAmount > SampleType{1.0};
+        
+        if (highCutActive)
         {
-            highCutActive = false;
+            SampleType coefficients[BiquadCoefficientTable<SampleType>::numCoefficients];
+            highCutTable.lookup(cutAmount, coefficients);
+            highCutFilter.setCoefficients(coefficients);
         }
     }
     
     /** Processes a single sample. */
     SampleType processSample(SampleType input)
+        requires (NumChannels == 1)
+    {
+        processFrames(&input, 1);
+        return input;
+    }
+    
+    /** Processes a block of interleaved frames in place. */
+    void processFrames(SampleType* frames, int numFrames)
     {
-        SampleType output = input;
-        
         if (lowCutActive)
-            output = lowCutFilter.processSample(output);
-            
+            lowCutFilter.processFrames(frames, numFrames);
+        
         if (highCutActive)
-            output = highCutFilter.processSample(output);
-            
-        return output;
+            highCutFilter.processFrames(frames, numFrames);
     }
     
     /** Processes a block of samples. */
     void processBlock(juce::AudioBuffer<SampleType>& buffer)
     {
-        if (lowCutActive)
-        {
-            juce::dsp::AudioBlock<SampleType> block(buffer);
-            juce::dsp::ProcessContextReplacing<SampleType> context(block);
-            lowCutFilter.process(context);
-        }
+        auto numBufferChannels = juce::jmin(static_cast<size_t>(buffer.getNumChannels()), NumChannels);
+        std::array<SampleType, NumChannels> frame {};
         
-        if (highCutActive)
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
         {
-            juce::dsp::AudioBlock<SampleType> block(buffer);
-            juce::dsp::ProcessContextReplacing<SampleType> context(block);
-            highCutFilter.process(context);
+            for (size_t channel = 0; channel < numBufferChannels; ++channel)
+                frame[channel] = buffer.getSample(static_cast<int>(channel), i);
+            
+            processFrames(frame.data(), 1);
+            
+            for (size_t channel = 0; channel < numBufferChannels; ++channel)
+                buffer.setSample(static_cast<int>(channel), i, frame[channel]);
         }
     }
     
@@ -170,10 +230,37 @@ public:
         lowCutFilter.reset();
         highCutFilter.reset();
     }
+    
+    /** The filters' running state: coefficients, history and which cuts are active. */
+    struct State
+    {
+        MultiChannelBiquad<SampleType, NumChannels> lowCutFilter;
+        MultiChannelBiquad<SampleType, NumChannels> highCutFilter;
+        bool lowCutActive;
+        bool highCutActive;
+    };
+    
+    /** Returns the running state, see State. */
+    State getState() const
+    {
+        return { lowCutFilter, highCutFilter, lowCutActive, highCutActive };
+    }
+    
+    /** Restores a state returned by getState(). */
+    void setState(const State& state)
+    {
+        lowCutFilter = state.lowCutFilter;
+        highCutFilter = state.highCutFilter;
+        lowCutActive = state.lowCutActive;
+        highCutActive = state.highCutActive;
+    }
 
 private:
-    juce::dsp::IIR::Filter<SampleType> lowCutFilter;
-    juce::dsp::IIR::Filter<SampleType> highCutFilter;
+    Utils::StateArena ownedState;
+    MultiChannelBiquad<SampleType, NumChannels> lowCutFilter;
+    MultiChannelBiquad<SampleType, NumChannels> highCutFilter;
+    BiquadCoefficientTable<SampleType> lowCutTable;
+    BiquadCoefficientTable<SampleType> highCutTable;
     double sampleRate = 44100.0;
     bool lowCutActive = false;
     bool highCutActive = false;
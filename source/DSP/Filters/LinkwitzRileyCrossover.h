@@ -0,0 +1,133 @@
+#pragma once
+
+#include "MultiChannelBiquad.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <cmath>
+
+namespace DSP {
+namespace Filters {
+
+/**
+ * A four-band crossover built from 4th-order Linkwitz-Riley splits, computing
+ * all four bands together as SIMD lanes of one MultiChannelBiquadCascade.
+ *
+ * The split is the usual tree, flattened so that every lane does useful work
+ * in every section:
+ * - two sections split the signal at the middle crossover (lanes 0-1 low-pass,
+ *   lanes 2-3 high-pass)
+ * - two sections split each half again at the low and high crossovers
+ * - one section runs each half through the allpass of the other half's
+ *   crossover, so the bands stay phase aligned and sum to an allpass
+ *
+ * A frame of all four bands therefore costs five SIMD biquad steps.
+ */
+template<typename SampleType>
+class LinkwitzRileyCrossoverBank
+{
+public:
+    static constexpr size_t numBands = 4;
+    static constexpr size_t numCrossovers = numBands - 1;
+    
+    /** Creates a bank with crossovers at 150 Hz, 1 kHz and 5 kHz. */
+    LinkwitzRileyCrossoverBank()
+    {
+        updateCoefficients();
+    }
+    
+    /** Prepares the bank and recomputes the coefficients for the new sample rate. */
+    void prepare(double newSampleRate)
+    {
+        sampleRate = newSampleRate;
+        updateCoefficients();
+        reset();
+    }
+    
+    /** Sets the crossover frequencies in Hz, in ascending order. */
+    void setCrossoverFrequencies(const std::array<SampleType, numCrossovers>& newFrequencies)
+    {
+        jassert(newFrequencies[0] <= newFrequencies[1] && newFrequencies[1] <= newFrequencies[2]);
+        
+        crossoverFrequencies = newFrequencies;
+        updateCoefficients();
+    }
+    
+    /** Returns the crossover frequencies in Hz. */
+    const std::array<SampleType, numCrossovers>& getCrossoverFrequencies() const
+    {
+        return crossoverFrequencies;
+    }
+    
+    /** Processes a block of frames of four samples in place. On entry every lane of a
+        frame holds the input sample; on exit lane b holds band b, lowest band first. */
+    void processFrames(SampleType* frames, int numFrames)
+    {
+        sections.processFrames(frames, numFrames);
+    }
+    
+    /** Resets the filter state of every band. */
+    void reset()
+    {
+        sections.reset();
+    }
+
+private:
+    /** Butterworth (Q = 1/sqrt(2)) sections for one crossover frequency. Two low-pass
+        or two high-pass sections in series make the Linkwitz-Riley filters, and the
+        two filters sum to the allpass section. */
+    struct CrossoverSections
+    {
+        std::array<SampleType, 5> lowPass, highPass, allPass;
+    };
+    
+    MultiChannelBiquadCascade<SampleType, numBands, 5> sections;
+    std::array<SampleType, numCrossovers> crossoverFrequencies { SampleType{150}, SampleType{1000}, SampleType{5000} };
+    double sampleRate = 44100.0;
+    
+    CrossoverSections makeSections(SampleType crossoverFrequency) const
+    {
+        // Bilinear transform of the analogue Butterworth prototype
+        const auto frequency = juce::jlimit(10.0, 0.49 * sampleRate, static_cast<double>(crossoverFrequency));
+        const auto k = std::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+        const auto norm = 1.0 / (1.0 + juce::MathConstants<double>::sqrt2 * k + k * k);
+        const auto a1 = static_cast<SampleType>(2.0 * (k * k - 1.0) * norm);
+        const auto a2 = static_cast<SampleType>((1.0 - juce::MathConstants<double>::sqrt2 * k + k * k) * norm);
+        const auto lowPassGain = static_cast<SampleType>(k * k * norm);
+        const auto highPassGain = static_cast<SampleType>(norm);
+        
+        return { { lowPassGain, SampleType{2} * lowPassGain, lowPassGain, a1, a2 },
+                 { highPassGain, SampleType{-2} * highPassGain, highPassGain, a1, a2 },
+                 { a2, a1, SampleType{1}, a1, a2 } };
+    }
+    
+    void updateCoefficients()
+    {
+        const auto low = makeSections(crossoverFrequencies[0]);
+        const auto middle = makeSections(crossoverFrequencies[1]);
+        const auto high = makeSections(crossoverFrequencies[2]);
+        
+        for (size_t section = 0; section < 2; ++section)
+        {
+            // Split at the middle crossover
+            sections.setCoefficients(section, 0, middle.lowPass.data());
+            sections.setCoefficients(section, 1, middle.lowPass.data());
+            sections.setCoefficients(section, 2, middle.highPass.data());
+            sections.setCoefficients(section, 3, middle.highPass.data());
+            
+            // Split each half again
+            sections.setCoefficients(section + 2, 0, low.lowPass.data());
+            sections.setCoefficients(section + 2, 1, low.highPass.data());
+            sections.setCoefficients(section + 2, 2, high.lowPass.data());
+            sections.setCoefficients(section + 2, 3, high.highPass.data());
+        }
+        
+        // Phase compensation: each half picks up the allpass of the other half's split
+        sections.setCoefficients(4, 0, high.allPass.data());
+        sections.setCoefficients(4, 1, high.allPass.data());
+        sections.setCoefficients(4, 2, low.allPass.data());
+        sections.setCoefficients(4, 3, low.allPass.data());
+    }
+};
+
+} // namespace Filters
+} // namespace DSP
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "../Utils/DSPUtils.h"
+#include "../Utils/SIMDLanes.h"
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <utility>
+
+namespace DSP {
+namespace Filters {
+
+/**
+ * A second-order IIR filter (transposed direct form II) that processes
+ * NumChannels channels at once as interleaved frames.
+ *
+ * Coefficients and state are held per channel in structure-of-arrays layout,
+ * so each channel keeps its own independent history while one frame of all
+ * channels is computed with a single SIMD operation per step (see LaneVector).
+ *
+ * Coefficients use JUCE's normalised order: b0, b1, b2, a1, a2.
+ *
+ * The state is flushed to zero at the end of every block once it decays below
+ * 1e-30, so silence never leaves denormals behind in the feedback path.
+ */
+template<typename SampleType, size_t NumChannels>
+class MultiChannelBiquad
+{
+public:
+    static constexpr size_t numCoefficients = 5;
+    
+    MultiChannelBiquad() = default;
+    
+    /** Sets the same coefficients for every channel. */
+    void setCoefficients(const SampleType* coefficients)
+    {
+        b0.fill(coefficients[0]);
+        b1.fill(coefficients[1]);
+        b2.fill(coefficients[2]);
+        a1.fill(coefficients[3]);
+        a2.fill(coefficients[4]);
+    }
+    
+    /** Sets the coefficients for a single channel. */
+    void setCoefficients(size_t channel, const SampleType* coefficients)
+    {
+        jassert(channel < NumChannels);
+        
+        b0[channel] = coefficients[0];
+        b1[channel] = coefficients[1];
+        b2[channel] = coefficients[2];
+        a1[channel] = coefficients[3];
+        a2[channel] = coefficients[4];
+    }
+    
+    /** Processes a block of interleaved frames in place. */
+    void processFrames(SampleType* frames, int numFrames)
+    {
+        const auto B0 = Lanes::load(b0.data());
+        const auto B1 = Lanes::load(b1.data());
+        const auto B2 = Lanes::load(b2.data());
+        const auto A1 = Lanes::load(a1.data());
+        const auto A2 = Lanes::load(a2.data());
+        
+        auto S1 = Lanes::load(s1.data());
+        auto S2 = Lanes::load(s2.data());
+        
+        for (int i = 0; i < numFrames; ++i)
+        {
+            auto* frame = frames + static_cast<size_t>(i) * NumChannels;
+            
+            auto x = Lanes::load(frame);
+            auto y = B0 * x + S1;
+            
+            S1 = B1 * x - A1 * y + S2;
+            S2 = B2 * x - A2 * y;
+            
+            y.store(frame);
+        }
+        
+        S1.store(s1.data());
+        S2.store(s2.data());
+        
+        for (size_t channel = 0; channel < NumChannels; ++channel)
+        {
+            s1[channel] = Utils::DSPUtils::flushDenormalToZero(s1[channel]);
+            s2[channel] = Utils::DSPUtils::flushDenormalToZero(s2[channel]);
+        }
+    }
+    
+    /** Resets the filter state of every channel. */
+    void reset()
+    {
+        s1.fill(SampleType{0});
+        s2.fill(SampleType{0});
+    }
+
+private:
+    using Lanes = Utils::LaneVector<SampleType, NumChannels>;
+    
+    // Identity filter until coefficients are set
+    alignas(16) std::array<SampleType, NumChannels> b0 { filled(SampleType{1}) };
+    alignas(16) std::array<SampleType, NumChannels> b1 {};
+    alignas(16) std::array<SampleType, NumChannels> b2 {};
+    alignas(16) std::array<SampleType, NumChannels> a1 {};
+    alignas(16) std::array<SampleType, NumChannels> a2 {};
+    
+    alignas(16) std::array<SampleType, NumChannels> s1 {};
+    alignas(16) std::array<SampleType, NumChannels> s2 {};
+    
+    static constexpr std::array<SampleType, NumChannels> filled(SampleType value)
+    {
+        std::array<SampleType, NumChannels> result {};
+        result.fill(value);
+        return result;
+    }
+};
+
+/**
+ * NumStages MultiChannelBiquad sections in series, processed frame by frame.
+ *
+ * Running each section over the whole block in turn would wait on every
+ * section's feedback path one after the other. Here each frame goes through
+ * all sections before the next frame starts, so the recursions of different
+ * sections overlap and the cascade costs about as much as its arithmetic.
+ */
+template<typename SampleType, size_t NumChannels, size_t NumStages>
+class MultiChannelBiquadCascade
+{
+public:
+    static constexpr size_t numStages = NumStages;
+    
+    MultiChannelBiquadCascade() = default;
+    
+    /** Sets the coefficients of one section for a single channel. */
+    void setCoefficients(size_t stage, size_t channel, const SampleType* coefficients)
+    {
+        jassert(stage < NumStages && channel < NumChannels);
+        
+        for (size_t i = 0; i < MultiChannelBiquad<SampleType, NumChannels>::numCoefficients; ++i)
+            coefficientLanes[stage][i][channel] = coefficients[i];
+    }
+    
+    /** Processes a block of interleaved frames in place. */
+    void processFrames(SampleType* frames, int numFrames)
+    {
+        std::array<std::array<Lanes, 5>, NumStages> c;
+        std::array<Lanes, NumStages> S1, S2;
+        
+        for (size_t stage = 0; stage < NumStages; ++stage)
+        {
+            for (size_t i = 0; i < 5; ++i)
+                c[stage][i] = Lanes::load(coefficientLanes[stage][i].data());
+            
+            S1[stage] = Lanes::load(s1[stage].data());
+            S2[stage] = Lanes::load(s2[stage].data());
+        }
+        
+        for (int i = 0; i < numFrames; ++i)
+        {
+            auto* frame = frames + static_cast<size_t>(i) * NumChannels;
+            auto x = Lanes::load(frame);
+            
+            // Unrolled at compile time so the section states stay in registers
+            [&]<size_t... Stage>(std::index_sequence<Stage...>)
+            {
+                ((x = processSection(c[Stage], S1[Stage], S2[Stage], x)), ...);
+            }(std::make_index_sequence<NumStages>());
+            
+            x.store(frame);
+        }
+        
+        for (size_t stage = 0; stage < NumStages; ++stage)
+        {
+            S1[stage].store(s1[stage].data());
+            S2[stage].store(s2[stage].data());
+            
+            for (size_t channel = 0; channel < NumChannels; ++channel)
+            {
+                s1[stage][channel] = Utils::DSPUtils::flushDenormalToZero(s1[stage][channel]);
+                s2[stage][channel] = Utils::DSPUtils::flushDenormalToZero(s2[stage][channel]);
+            }
+        }
+    }
+    
+    /** Resets the filter state of every section. */
+    void reset()
+    {
+        for (size_t stage = 0; stage < NumStages; ++stage)
+        {
+            s1[stage].fill(SampleType{0});
+            s2[stage].fill(SampleType{0});
+        }
+    }
+
+private:
+    using Lanes = Utils::LaneVector<SampleType, NumChannels>;
+    using ChannelArray = std::array<SampleType, NumChannels>;
+    
+    static Lanes processSection(const std::array<Lanes, 5>& k, Lanes& S1, Lanes& S2, Lanes x)
+    {
+        auto y = k[0] * x + S1;
+        
+        S1 = k[1] * x - k[3] * y + S2;
+        S2 = k[2] * x - k[4] * y;
+        return y;
+    }
+    
+    // Per section b0, b1, b2, a1, a2 for every channel; identity until set
+    alignas(16) std::array<std::array<ChannelArray, 5>, NumStages> coefficientLanes { identity() };
+    alignas(16) std::array<ChannelArray, NumStages> s1 {};
+    alignas(16) std::array<ChannelArray, NumStages> s2 {};
+    
+    static constexpr std::array<std::array<ChannelArray, 5>, NumStages> identity()
+    {
+        std::array<std::array<ChannelArray, 5>, NumStages> result {};
+        
+        for (auto& stage : result)
+            stage[0].fill(SampleType{1});
+        
+        return result;
+    }
+};
+
+} // namespace Filters
+} // namespace DSP
@@ -2,8 +2,11 @@
 
 #include "AllpassFilter.h"
 #include "../Utils/ParameterSmoother.h"
+#include "../Utils/DSPUtils.h"
+#include "../Utils/StateArena.h"
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <array>
+#include <cmath>
 
 namespace DSP {
 namespace Filters {
@@ -11,17 +14,32 @@ namespace Filters {
 /**
  * A Schroeder allpass filter chain for creating dense, diffuse reverb textures.
  * Uses multiple allpass filters in series with carefully chosen delay times.
+ *
+ * With NumLanes > 1 the chain processes that many channels at once as interleaved
+ * frames, sharing delay memory and parameters (e.g. 2 lanes for a stereo pair).
+ *
+ * Each stage's delay line is sized for the longest delay it can actually reach,
+ * the maximum base delay times its scale, rather than the maximum for all of them.
  */
-template<typename SampleType>
+template<typename SampleType, size_t NumLanes = 1>
 class SchroederAllpassChain
 {
 public:
     static constexpr size_t NumAllpassFilters = 4;
     
+    /** Number of channels processed together in one interleaved frame. */
+    static constexpr size_t numLanes = NumLanes;
+    
     SchroederAllpassChain() = default;
     
     /** Prepares the chain with sample rate. */
     void prepare(double newSampleRate)
+    {
+        ownedState.build([&](Utils::StateArena& arena) { prepare(newSampleRate, arena); });
+    }
+    
+    /** Prepares the chain, taking the delay lines from arena (see StateArena::build). */
+    void prepare(double newSampleRate, Utils::StateArena& arena)
     {
         _sampleRate = newSampleRate;
         
@@ -31,7 +49,7 @@ public:
         
         for (size_t i = 0; i < NumAllpassFilters; ++i)
         {
-            allpassFilters[i].prepare(_sampleRate, 100.0); // Max 100ms delay
+            allpassFilters[i].prepare(_sampleRate, getMaxStageDelayMs(i), arena);
             allpassFilters[i].setDelayTime(delayTimes[i]);
             allpassFilters[i].setFeedback(SampleType{0.7}); // Default feedback
         }
@@ -45,12 +63,13 @@ public:
         
         delayTimeSmoother.snapToTargetValue();
         characterSmoother.snapToTargetValue();
+        parametersNeedUpdate = true;
     }
     
     /** Sets the base delay time (will be scaled for each filter). */
     void setDelayTime(SampleType delayMs)
     {
-        delayTimeSmoother.setTargetValue(juce::jlimit(SampleType{1.0}, SampleType{100.0}, delayMs));
+        delayTimeSmoother.setTargetValue(juce::jlimit(SampleType{1.0}, maxBaseDelayMs, delayMs));
     }
     
     /** Sets the character (feedback amount) - higher values = more resonant. */
@@ -61,27 +80,78 @@ public:
     
     /** Processes a single sample through the allpass chain. */
     SampleType processSample(SampleType input)
+        requires (NumLanes == 1)
     {
-        updateParameters();
-        
-        auto output = input;
+        processFrame(&input);
+        return input;
+    }
+    
+    /** Processes one interleaved frame of NumLanes samples in place. */
+    void processFrame(SampleType* frame)
+    {
+        updateParameters(delayTimeSmoother.getNextValue(), characterSmoother.getNextValue(), 0);
         
         // Process through each allpass filter in series
         for (auto& filter : allpassFilters)
         {
-            output = filter.processSample(output);
+            filter.processFrame(frame);
         }
-        
-        return output;
     }
     
-    /** Processes a block of samples. */
-    void processBlock(SampleType* samples, int numSamples)
+    /** Processes a block of interleaved frames in place (plain samples when NumLanes is 1).
+        Parameters are updated once for the whole block, so callers should keep
+        blocks at control-rate length (see ChasmDSPProcessor::controlBlockSize). */
+    void processBlock(SampleType* frames, int numFrames)
+    {
+        process(frames, frames, numFrames);
+    }
+    
+    /** Processes a block of interleaved frames from input to output, which may be the same.
+        Each stage evaluates the block in chunks bounded by its current delay
+        (see AllpassFilter::process). */
+    void process(const SampleType* input, SampleType* output, int numFrames)
     {
-        for (int i = 0; i < numSamples; ++i)
+        if (numFrames <= 0)
+            return;
+        
+        // Delays glide to their new values across the block; once both smoothers
+        // have settled the stages keep their current settings
+        if (parametersNeedUpdate || delayTimeSmoother.isSmoothing() || characterSmoother.isSmoothing())
         {
-            samples[i] = processSample(samples[i]);
+            updateParameters(delayTimeSmoother.skip(numFrames), characterSmoother.skip(numFrames), numFrames);
+            parametersNeedUpdate = false;
         }
+        
+        // Run each stage over the whole block before moving on to the next one
+        for (auto& filter : allpassFilters)
+        {
+            filter.process(input, output, numFrames);
+            input = output;
+        }
+    }
+    
+    /** Returns how long the chain keeps ringing after its input stops, until it has
+        decayed by decayDb, for the current delay and character targets.
+        Every trip round a stage's loop scales the signal by the feedback, and the
+        stages run in series, so their decay times add up. */
+    double getTailLengthSeconds(double decayDb) const
+    {
+        return getTailLengthSeconds(decayDb, delayTimeSmoother.getTargetValue(), characterSmoother.getTargetValue());
+    }
+    
+    /** Returns the tail length for a delay and character that need not be set yet. */
+    double getTailLengthSeconds(double decayDb, SampleType delayMs, SampleType character) const
+    {
+        auto feedback = static_cast<double>(feedbackForCharacter(juce::jlimit(SampleType{0.1}, SampleType{10.0}, character)));
+        auto numPasses = 1.0 + decayDb / (-20.0 * std::log10(feedback));
+        auto baseDelayMs = juce::jlimit(SampleType{1.0}, maxBaseDelayMs, delayMs);
+        
+        double totalDelayMs = 0.0;
+        
+        for (size_t i = 0; i < NumAllpassFilters; ++i)
+            totalDelayMs += juce::jmin(static_cast<double>(baseDelayMs * delayScales[i]), getMaxStageDelayMs(i));
+        
+        return totalDelayMs * 0.001 * numPasses;
     }
     
     /** Resets the filter chain. */
@@ -94,33 +164,96 @@ public:
         
         delayTimeSmoother.reset(SampleType{30.0});
         characterSmoother.reset(SampleType{1.0});
+        parametersNeedUpdate = true;
+    }
+    
+    /** Silences the chain and sets the delay and character without smoothing, so it
+        starts again from silence at the given settings. */
+    void reset(SampleType delayMs, SampleType character)
+    {
+        for (auto& filter : allpassFilters)
+        {
+            filter.reset();
+        }
+        
+        delayTimeSmoother.reset(juce::jlimit(SampleType{1.0}, maxBaseDelayMs, delayMs));
+        characterSmoother.reset(juce::jlimit(SampleType{0.1}, SampleType{10.0}, character));
+        updateParameters(delayTimeSmoother.getCurrentValue(), characterSmoother.getCurrentValue(), 0);
+        parametersNeedUpdate = false;
+    }
+    
+    /** The chain's running state apart from the delay line contents, which live in
+        its StateArena. Only valid for chains prepared at the same sample rate. */
+    struct State
+    {
+        std::array<typename AllpassFilter<SampleType, NumLanes>::State, NumAllpassFilters> filters;
+        Utils::ParameterSmoother<SampleType> delayTimeSmoother;
+        Utils::ParameterSmoother<SampleType> characterSmoother;
+        bool parametersNeedUpdate;
+    };
+    
+    /** Returns the running state, see State. */
+    State getState() const
+    {
+        State state { {}, delayTimeSmoother, characterSmoother, parametersNeedUpdate };
+        
+        for (size_t i = 0; i < NumAllpassFilters; ++i)
+            state.filters[i] = allpassFilters[i].getState();
+        
+        return state;
+    }
+    
+    /** Restores a state returned by getState(). */
+    void setState(const State& state)
+    {
+        for (size_t i = 0; i < NumAllpassFilters; ++i)
+            allpassFilters[i].setState(state.filters[i]);
+        
+        delayTimeSmoother = state.delayTimeSmoother;
+        characterSmoother = state.characterSmoother;
+        parametersNeedUpdate = state.parametersNeedUpdate;
     }
 
 private:
-    std::array<AllpassFilter<SampleType>, NumAllpassFilters> allpassFilters;
+    // Longest base delay, and the longest delay any stage can be set to
+    static constexpr SampleType maxBaseDelayMs = SampleType{100.0};
+    static constexpr double maxDelayMs = 100.0;
+    
+    // Delay time ratios of the stages relative to the base delay
+    static constexpr std::array<SampleType, NumAllpassFilters> delayScales = {
+        SampleType{0.41}, SampleType{0.66}, SampleType{0.97}, SampleType{1.25}
+    };
+    
+    Utils::StateArena ownedState;
+    std::array<AllpassFilter<SampleType, NumLanes>, NumAllpassFilters> allpassFilters;
     Utils::ParameterSmoother<SampleType> delayTimeSmoother;
     Utils::ParameterSmoother<SampleType> characterSmoother;
     
     double _sampleRate = 44100.0;
+    bool parametersNeedUpdate = true;
     
-    void updateParameters()
+    /** The longest delay stage i reaches, in milliseconds. */
+    static double getMaxStageDelayMs(size_t stage)
+    {
+        return juce::jmin(static_cast<double>(maxBaseDelayMs * delayScales[stage]), maxDelayMs);
+    }
+    
+    static SampleType feedbackForCharacter(SampleType character)
     {
-        auto baseDelayTime = delayTimeSmoother.getNextValue();
-        auto character = characterSmoother.getNextValue();
-        
         // Calculate feedback from character parameter (logarithmic scaling)
-        auto feedback = static_cast<SampleType>(0.3 + 0.6 * (std::log(character) / std::log(10.0)));
-        feedback = juce::jlimit(SampleType{0.1}, SampleType{0.9}, feedback);
+        auto feedback = SampleType{0.3} + SampleType{0.6} * Utils::DSPUtils::fastLog(character) * static_cast<SampleType>(0.4342944819032518);
+        return juce::jlimit(SampleType{0.1}, SampleType{0.9}, feedback);
+    }
+    
+    void updateParameters(SampleType baseDelayTime, SampleType character, int rampSamples)
+    {
+        auto feedback = feedbackForCharacter(character);
         
         // Scale delay times with different ratios for each filter
-        std::array<SampleType, NumAllpassFilters> delayScales = {
-            SampleType{0.41}, SampleType{0.66}, SampleType{0.97}, SampleType{1.25}
-        };
-        
         for (size_t i = 0; i < NumAllpassFilters; ++i)
         {
             auto scaledDelay = baseDelayTime * delayScales[i];
-            allpassFilters[i].setDelayTime(static_cast<double>(scaledDelay));
+            allpassFilters[i].setDelayTime(static_cast<double>(scaledDelay), rampSamples);
             allpassFilters[i].setFeedback(feedback);
         }
     }
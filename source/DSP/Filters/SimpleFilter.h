@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../Utils/DSPUtils.h"
 #include <juce_audio_basics/juce_audio_basics.h>
 
 namespace DSP {
@@ -81,6 +82,14 @@ public:
         }
     }
     
+    /** Flushes a decayed filter state to zero so it cannot turn denormal.
+        Call once per block; the per-sample path does not check. */
+    void snapToZero()
+    {
+        lastInput = Utils::DSPUtils::flushDenormalToZero(lastInput);
+        lastOutput = Utils::DSPUtils::flushDenormalToZero(lastOutput);
+    }
+    
     /** Resets the filter state. */
     void reset()
     {
@@ -108,7 +117,7 @@ private:
         }
         else
         {
-            auto alpha = std::exp(-omega);
+            auto alpha = Utils::DSPUtils::fastExp(-omega);
             a = static_cast<SampleType>(1.0 - alpha);
         }
     }
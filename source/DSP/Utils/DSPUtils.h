@@ -1,91 +1,284 @@
 #pragma once
 
 #include <juce_audio_basics/juce_audio_basics.h>
+#include <bit>
 #include <cmath>
+#include <cstdint>
 
 namespace DSP {
 namespace Utils {
 
+/**
+ * Bit layout of the floating point types used by the fast math functions.
+ */
+template<typename SampleType>
+struct FloatBits;
+
+template<>
+struct FloatBits<float>
+{
+    using IntType = int32_t;
+    static constexpr int mantissaBits = 23;
+    static constexpr IntType exponentBias = 127;
+    static constexpr IntType exponentMask = 0xff;
+    
+    // exp() arguments are clamped so 2^n stays a normal number
+    static constexpr float minExpArgument = -87.0f;
+    static constexpr float maxExpArgument = 88.0f;
+    
+    // ln(2) split so that n * ln2High is exact for the n that can occur
+    static constexpr float ln2High = 0.693359375f;
+    static constexpr float ln2Low = -2.12194440e-4f;
+};
+
+template<>
+struct FloatBits<double>
+{
+    using IntType = int64_t;
+    static constexpr int mantissaBits = 52;
+    static constexpr IntType exponentBias = 1023;
+    static constexpr IntType exponentMask = 0x7ff;
+    
+    static constexpr double minExpArgument = -708.0;
+    static constexpr double maxExpArgument = 709.0;
+    
+    static constexpr double ln2High = 6.93145751953125e-1;
+    static constexpr double ln2Low = 1.42860682030941723212e-6;
+};
+
 /**
  * Utility functions for DSP processing.
+ * Every function is templated on the sample type, so float and double
+ * processors share the same code without converting through float.
  */
 class DSPUtils
 {
 public:
     /** Converts decibels to linear gain. */
-    static inline float dbToGain(float db)
+    template<typename SampleType>
+    static inline SampleType dbToGain(SampleType db)
     {
-        return std::pow(10.0f, db * 0.05f);
+        return std::pow(SampleType{10}, db * SampleType{0.05});
     }
     
     /** Converts linear gain to decibels. */
-    static inline float gainToDb(float gain)
+    template<typename SampleType>
+    static inline SampleType gainToDb(SampleType gain)
     {
-        return 20.0f * std::log10(std::max(gain, 1e-6f));
+        return SampleType{20} * std::log10(std::max(gain, SampleType{1e-6}));
     }
     
     /** Converts percentage (0-100) to normalized value (0-1). */
-    static inline float percentageToNormalized(float percentage)
+    template<typename SampleType>
+    static inline SampleType percentageToNormalized(SampleType percentage)
     {
-        return juce::jlimit(0.0f, 1.0f, percentage * 0.01f);
+        return juce::jlimit(SampleType{0}, SampleType{1}, percentage * SampleType{0.01});
     }
     
     /** Converts normalized value (0-1) to percentage (0-100). */
-    static inline float normalizedToPercentage(float normalized)
+    template<typename SampleType>
+    static inline SampleType normalizedToPercentage(SampleType normalized)
     {
-        return juce::jlimit(0.0f, 100.0f, normalized * 100.0f);
+        return juce::jlimit(SampleType{0}, SampleType{100}, normalized * SampleType{100});
     }
     
     /** Logarithmic scaling for delay time (1-100ms range). */
-    static inline float normalizedToDelayMs(float normalized)
+    template<typename SampleType>
+    static inline SampleType normalizedToDelayMs(SampleType normalized)
     {
         // Logarithmic scaling from 1ms to 100ms
-        return 1.0f + (99.0f * std::pow(normalized, 2.0f));
+        return SampleType{1} + (SampleType{99} * std::pow(normalized, SampleType{2}));
     }
     
     /** Inverse logarithmic scaling for delay time. */
-    static inline float delayMsToNormalized(float delayMs)
+    template<typename SampleType>
+    static inline SampleType delayMsToNormalized(SampleType delayMs)
     {
         // Inverse of logarithmic scaling
-        return std::sqrt((delayMs - 1.0f) / 99.0f);
+        return std::sqrt((delayMs - SampleType{1}) / SampleType{99});
     }
     
     /** Logarithmic scaling for Q factor (0.1-10 range). */
-    static inline float normalizedToQFactor(float normalized)
+    template<typename SampleType>
+    static inline SampleType normalizedToQFactor(SampleType normalized)
     {
         // Logarithmic scaling from 0.1 to 10
-        return 0.1f * std::pow(100.0f, normalized);
+        return SampleType{0.1} * std::pow(SampleType{100}, normalized);
     }
     
     /** Inverse logarithmic scaling for Q factor. */
-    static inline float qFactorToNormalized(float qFactor)
+    template<typename SampleType>
+    static inline SampleType qFactorToNormalized(SampleType qFactor)
     {
         // Inverse of logarithmic scaling
-        return std::log10(qFactor / 0.1f) / 2.0f;
+        return std::log10(qFactor / SampleType{0.1}) / SampleType{2};
     }
     
     /** Soft clipping for audio signals. */
-    static inline float softClip(float input)
+    template<typename SampleType>
+    static inline SampleType softClip(SampleType input)
     {
-        return std::tanh(input);
+        return fastTanh(input);
     }
     
     /** Hard clipping for audio signals. */
-    static inline float hardClip(float input, float threshold = 1.0f)
+    template<typename SampleType>
+    static inline SampleType hardClip(SampleType input, SampleType threshold = SampleType{1})
     {
         return juce::jlimit(-threshold, threshold, input);
     }
     
     /** Linear interpolation between two values. */
-    static inline float lerp(float a, float b, float t)
+    template<typename SampleType>
+    static inline SampleType lerp(SampleType a, SampleType b, SampleType t)
     {
         return a + t * (b - a);
     }
     
     /** Check if a floating point number is denormal and flush to zero if needed. */
-    static inline float flushDenormalToZero(float input)
+    template<typename SampleType>
+    static inline SampleType flushDenormalToZero(SampleType input)
+    {
+        return std::abs(input) < SampleType{1e-30} ? SampleType{0} : input;
+    }
+    
+    //==============================================================================
+    // Fast math
+    //
+    // Polynomial approximations for the transcendentals used on the audio thread.
+    // They are branch-free, so the array versions vectorise (GCC needs fast math or
+    // -fno-trapping-math for the selects), and tests/FastMath.cpp checks their errors:
+    //   fastExp   relative error < 2e-8 for double, < 5e-6 for float
+    //   fastLog   absolute error < 2e-9 for double, < 1e-5 for float
+    //   fastTanh  relative error < 5e-8 for double, < 2e-6 for float
+    // The float bounds are a few ulp at the top of the range and leave room for
+    // fast math reassociating the argument reduction. fastPow and fastDbToGain
+    // inherit the error of fastExp.
+    
+    /** Fast e^x. Arguments are clamped to the range where the result is a normal number. */
+    template<typename SampleType>
+    static inline SampleType fastExp(SampleType x)
+    {
+        using Bits = FloatBits<SampleType>;
+        
+        x = std::max(Bits::minExpArgument, std::min(x, Bits::maxExpArgument));
+        
+        // Split x = n ln2 + r with |r| <= ln2 / 2. Adding the exponent bias first keeps the
+        // value positive, so the truncating conversion rounds n to nearest, and the
+        // result already is the biased exponent of 2^n
+        auto biasedExponent = static_cast<typename Bits::IntType>(x * static_cast<SampleType>(1.4426950408889634)
+                                                                  + static_cast<SampleType>(Bits::exponentBias) + SampleType{0.5});
+        auto n = static_cast<SampleType>(biasedExponent - Bits::exponentBias);
+        auto r = x - n * Bits::ln2High - n * Bits::ln2Low;
+        
+        // Taylor series of e^r, truncation error below 5.2e-9 for |r| <= ln2 / 2
+        auto p = SampleType{1} + r * (SampleType{1} + r * (SampleType{1.0 / 2.0} + r * (SampleType{1.0 / 6.0}
+               + r * (SampleType{1.0 / 24.0} + r * (SampleType{1.0 / 120.0} + r * (SampleType{1.0 / 720.0}
+               + r * SampleType{1.0 / 5040.0}))))));
+        
+        // Scale by 2^n by building its exponent bits directly
+        return p * std::bit_cast<SampleType>(biasedExponent << Bits::mantissaBits);
+    }
+    
+    /** Fast natural logarithm. The input must be a positive normal number. */
+    template<typename SampleType>
+    static inline SampleType fastLog(SampleType x)
+    {
+        using Bits = FloatBits<SampleType>;
+        using IntType = typename Bits::IntType;
+        
+        jassert(x > SampleType{0});
+        
+        // Split x = m 2^e with m in [1, 2)
+        auto bits = std::bit_cast<IntType>(x);
+        auto exponent = ((bits >> Bits::mantissaBits) & Bits::exponentMask) - Bits::exponentBias;
+        auto m = std::bit_cast<SampleType>((bits & ((IntType{1} << Bits::mantissaBits) - 1)) | (Bits::exponentBias << Bits::mantissaBits));
+        
+        // Centre m on 1, in [sqrt(1/2), sqrt(2))
+        auto isLarge = m > static_cast<SampleType>(1.4142135623730951);
+        m = isLarge ? m * SampleType{0.5} : m;
+        exponent += isLarge ? 1 : 0;
+        
+        // ln(m) = 2 atanh(s), with |s| <= 0.1716 the series error is below 1e-9
+        auto s = (m - SampleType{1}) / (m + SampleType{1});
+        auto s2 = s * s;
+        auto logM = SampleType{2} * s * (SampleType{1} + s2 * (SampleType{1.0 / 3.0} + s2 * (SampleType{1.0 / 5.0}
+                  + s2 * (SampleType{1.0 / 7.0} + s2 * SampleType{1.0 / 9.0}))));
+        
+        return static_cast<SampleType>(exponent) * static_cast<SampleType>(0.6931471805599453) + logM;
+    }
+    
+    /** Fast base^exponent for a positive base. */
+    template<typename SampleType>
+    static inline SampleType fastPow(SampleType base, SampleType exponent)
+    {
+        return fastExp(exponent * fastLog(base));
+    }
+    
+    /** Fast hyperbolic tangent. */
+    template<typename SampleType>
+    static inline SampleType fastTanh(SampleType x)
+    {
+        // tanh(|x|) = 1 - 2 / (e^2|x| + 1), which rounds to 1 beyond |x| = 20
+        auto magnitude = juce::jmin(std::abs(x), SampleType{20});
+        auto large = SampleType{1} - SampleType{2} / (fastExp(SampleType{2} * magnitude) + SampleType{1});
+        
+        // Near zero the difference above cancels, so use the odd Taylor series instead
+        // (error below 1.3e-9 relative for |x| < 0.125)
+        auto x2 = magnitude * magnitude;
+        auto small = magnitude * (SampleType{1} + x2 * (SampleType{-1.0 / 3.0} + x2 * (SampleType{2.0 / 15.0}
+                   + x2 * SampleType{-17.0 / 315.0})));
+        
+        auto result = magnitude < SampleType{0.125} ? small : large;
+        return x < SampleType{0} ? -result : result;
+    }
+    
+    /** Fast conversion from decibels to linear gain. */
+    template<typename SampleType>
+    static inline SampleType fastDbToGain(SampleType db)
+    {
+        // 10^(db / 20) = e^(db ln(10) / 20)
+        return fastExp(db * static_cast<SampleType>(0.11512925464970229));
+    }
+    
+    /** Fast conversion from linear gain to decibels. */
+    template<typename SampleType>
+    static inline SampleType fastGainToDb(SampleType gain)
+    {
+        // 20 log10(gain) = ln(gain) 20 / ln(10)
+        return fastLog(std::max(gain, SampleType{1e-6})) * static_cast<SampleType>(8.685889638065035);
+    }
+    
+    /** Fast e^x over an array. Input and output may be the same. */
+    template<typename SampleType>
+    static inline void fastExp(const SampleType* input, SampleType* output, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = fastExp(input[i]);
+    }
+    
+    /** Fast natural logarithm over an array. Input and output may be the same. */
+    template<typename SampleType>
+    static inline void fastLog(const SampleType* input, SampleType* output, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = fastLog(input[i]);
+    }
+    
+    /** Fast hyperbolic tangent over an array. Input and output may be the same. */
+    template<typename SampleType>
+    static inline void fastTanh(const SampleType* input, SampleType* output, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = fastTanh(input[i]);
+    }
+    
+    /** Fast decibels to linear gain over an array. Input and output may be the same. */
+    template<typename SampleType>
+    static inline void fastDbToGain(const SampleType* input, SampleType* output, int numSamples)
     {
-        return std::abs(input) < 1e-30f ? 0.0f : input;
+        for (int i = 0; i < numSamples; ++i)
+            output[i] = fastDbToGain(input[i]);
     }
 };
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "DSPUtils.h"
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <cmath>
 
@@ -34,6 +35,8 @@ public:
         {
             smoothingCoeff = static_cast<SampleType>(1.0);
         }
+        
+        skipLength = 0;
     }
     
     /** Sets the target value to smooth towards. */
@@ -48,7 +51,34 @@ public:
         currentValue += smoothingCoeff * (targetValue - currentValue);
         return currentValue;
     }
-    
+
+    /** Advances the smoother by a number of samples in one step and returns the new value.
+        Equivalent to calling getNextValue() numSamples times, except that the value
+        snaps onto the target once it is within a negligible distance of it. */
+    SampleType skip(int numSamples)
+    {
+        if (numSamples <= 0)
+            return currentValue;
+
+        // Decay factor (1 - coeff)^n is cached for the most recent skip length, which
+        // changes on the audio thread whenever a host block leaves a shorter sub-block
+        if (numSamples != skipLength)
+        {
+            skipLength = numSamples;
+            auto decay = SampleType{1} - smoothingCoeff;
+            skipFactor = decay > SampleType{0} ? DSPUtils::fastPow(decay, static_cast<SampleType>(numSamples)) : SampleType{0};
+        }
+
+        currentValue = targetValue + (currentValue - targetValue) * skipFactor;
+        
+        // Land exactly on the target once the remaining distance is negligible,
+        // so callers can use isSmoothing() to skip work for settled parameters
+        if (std::abs(currentValue - targetValue) <= settleTolerance * (std::abs(targetValue) + SampleType{1}))
+            currentValue = targetValue;
+        
+        return currentValue;
+    }
+
     /** Processes a block of samples with the same target value. */
     void processBlock(SampleType* samples, int numSamples, SampleType newTargetValue)
     {
@@ -72,6 +102,20 @@ public:
     /** Gets the target value. */
     SampleType getTargetValue() const { return targetValue; }
     
+    /** Returns how many samples skip() can take to land exactly on the target after a
+        jump of up to maxRelativeJump times the target's magnitude plus one. */
+    int getSettlingSamples(double maxRelativeJump) const
+    {
+        if (smoothingCoeff >= SampleType{1} || maxRelativeJump <= static_cast<double>(settleTolerance))
+            return 0;
+        
+        const auto decayPerSample = std::log(1.0 - static_cast<double>(smoothingCoeff));
+        return static_cast<int>(std::ceil(std::log(static_cast<double>(settleTolerance) / maxRelativeJump) / decayPerSample));
+    }
+    
+    /** Returns true while the current value is still moving towards the target. */
+    bool isSmoothing() const { return currentValue != targetValue; }
+    
     /** Resets the smoother to a specific value. */
     void reset(SampleType initialValue = SampleType{0})
     {
@@ -79,11 +123,16 @@ public:
     }
 
 private:
+    // Relative distance below which skip() snaps onto the target (about -100 dB)
+    static constexpr SampleType settleTolerance = static_cast<SampleType>(1.0e-5);
+    
     double _sampleRate = 44100.0;
     double _smoothingTimeMs = 0.0;
     SampleType smoothingCoeff = SampleType{1};
     SampleType currentValue = SampleType{0};
     SampleType targetValue = SampleType{0};
+    SampleType skipFactor = SampleType{0};
+    int skipLength = 0;
 };
 
 } // namespace Utils
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#if defined (__SSE2__) || defined (_M_X64) || defined (__amd64__) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define CHASM_SIMD_SSE 1
+#elif defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64)
+    #include <arm_neon.h>
+    #define CHASM_SIMD_NEON 1
+#endif
+
+namespace DSP {
+namespace Utils {
+
+/**
+ * A small fixed-width vector of NumLanes samples, used to process interleaved
+ * multi-channel frames (e.g. a stereo pair) with one SIMD operation per step.
+ *
+ * The generic version is a plain lane loop; float x2, float x4 and double x2
+ * map directly onto SSE2 or NEON registers. Loads and stores are unaligned.
+ */
+template<typename SampleType, size_t NumLanes>
+struct LaneVector
+{
+    std::array<SampleType, NumLanes> lanes;
+    
+    static LaneVector load(const SampleType* source)
+    {
+        LaneVector result;
+        for (size_t i = 0; i < NumLanes; ++i)
+            result.lanes[i] = source[i];
+        return result;
+    }
+    
+    static LaneVector expand(SampleType value)
+    {
+        LaneVector result;
+        result.lanes.fill(value);
+        return result;
+    }
+    
+    void store(SampleType* destination) const
+    {
+        for (size_t i = 0; i < NumLanes; ++i)
+            destination[i] = lanes[i];
+    }
+    
+    friend LaneVector operator+(LaneVector a, const LaneVector& b)
+    {
+        for (size_t i = 0; i < NumLanes; ++i)
+            a.lanes[i] += b.lanes[i];
+        return a;
+    }
+    
+    friend LaneVector operator-(LaneVector a, const LaneVector& b)
+    {
+        for (size_t i = 0; i < NumLanes; ++i)
+            a.lanes[i] -= b.lanes[i];
+        return a;
+    }
+    
+    friend LaneVector operator*(LaneVector a, const LaneVector& b)
+    {
+        for (size_t i = 0; i < NumLanes; ++i)
+            a.lanes[i] *= b.lanes[i];
+        return a;
+    }
+};
+
+#if CHASM_SIMD_SSE
+
+template<>
+struct LaneVector<float, 4>
+{
+    __m128 value;
+    
+    static LaneVector load(const float* source) { return { _mm_loadu_ps(source) }; }
+    static LaneVector expand(float v) { return { _mm_set1_ps(v) }; }
+    void store(float* destination) const { _mm_storeu_ps(destination, value); }
+    
+    friend LaneVector operator+(LaneVector a, LaneVector b) { return { _mm_add_ps(a.value, b.value) }; }
+    friend LaneVector operator-(LaneVector a, LaneVector b) { return { _mm_sub_ps(a.value, b.value) }; }
+    friend LaneVector operator*(LaneVector a, LaneVector b) { return { _mm_mul_ps(a.value, b.value) }; }
+};
+
+/** A stereo float pair lives in the low half of an SSE register. The pair is moved
+    through __m64, which may alias floats; going through double* would let the
+    compiler reorder plain float accesses around the load or store. */
+template<>
+struct LaneVector<float, 2>
+{
+    __m128 value;
+    
+    static LaneVector load(const float* source) { return { _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(source)) }; }
+    static LaneVector expand(float v) { return { _mm_set1_ps(v) }; }
+    void store(float* destination) const { _mm_storel_pi(reinterpret_cast<__m64*>(destination), value); }
+    
+    friend LaneVector operator+(LaneVector a, LaneVector b) { return { _mm_add_ps(a.value, b.value) }; }
+    friend LaneVector operator-(LaneVector a, LaneVector b) { return { _mm_sub_ps(a.value, b.value) }; }
+    friend LaneVector operator*(LaneVector a, LaneVector b) { return { _mm_mul_ps(a.value, b.value) }; }
+};
+
+template<>
+struct LaneVector<double, 2>
+{
+    __m128d value;
+    
+    static LaneVector load(const double* source) { return { _mm_loadu_pd(source) }; }
+    static LaneVector expand(double v) { return { _mm_set1_pd(v) }; }
+    void store(double* destination) const { _mm_storeu_pd(destination, value); }
+    
+    friend LaneVector operator+(LaneVector a, LaneVector b) { return { _mm_add_pd(a.value, b.value) }; }
+    friend LaneVector operator-(LaneVector a, LaneVector b) { return { _mm_sub_pd(a.value, b.value) }; }
+    friend LaneVector operator*(LaneVector a, LaneVector b) { return { _mm_mul_pd(a.value, b.value) }; }
+};
+
+#elif CHASM_SIMD_NEON
+
+template<>
+struct LaneVector<float, 4>
+{
+    float32x4_t value;
+    
+    static LaneVector load(const float* source) { return { vld1q_f32(source) }; }
+    static LaneVector expand(float v) { return { vdupq_n_f32(v) }; }
+    void store(float* destination) const { vst1q_f32(destination, value); }
+    
+    friend LaneVector operator+(LaneVector a, LaneVector b) { return { vaddq_f32(a.value, b.value) }; }
+    friend LaneVector operator-(LaneVector a, LaneVector b) { return { vsubq_f32(a.value, b.value) }; }
+    friend LaneVector operator*(LaneVector a, LaneVector b) { return { vmulq_f32(a.value, b.value) }; }
+};
+
+template<>
+struct LaneVector<float, 2>
+{
+    float32x2_t value;
+    
+    static LaneVector load(const float* source) { return { vld1_f32(source) }; }
+    static LaneVector expand(float v) { return { vdup_n_f32(v) }; }
+    void store(float* destination) const { vst1_f32(destination, value); }
+    
+    friend LaneVector operator+(LaneVector a, LaneVector b) { return { vadd_f32(a.value, b.value) }; }
+    friend LaneVector operator-(LaneVector a, LaneVector b) { return { vsub_f32(a.value, b.value) }; }
+    friend LaneVector operator*(LaneVector a, LaneVector b) { return { vmul_f32(a.value, b.value) }; }
+};
+
+    #if defined (__aarch64__) || defined (_M_ARM64)
+template<>
+struct LaneVector<double, 2>
+{
+    float64x2_t value;
+    
+    static LaneVector load(const double* source) { return { vld1q_f64(source) }; }
+    static LaneVector expand(double v) { return { vdupq_n_f64(v) }; }
+    void store(double* destination) const { vst1q_f64(destination, value); }
+    
+    friend LaneVector operator+(LaneVector a, LaneVector b) { return { vaddq_f64(a.value, b.value) }; }
+    friend LaneVector operator-(LaneVector a, LaneVector b) { return { vsubq_f64(a.value, b.value) }; }
+    friend LaneVector operator*(LaneVector a, LaneVector b) { return { vmulq_f64(a.value, b.value) }; }
+};
+    #endif
+
+#endif
+
+} // namespace Utils
+} // namespace DSP
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace DSP {
+namespace Utils {
+
+/**
+ * One contiguous, cache-line aligned block of memory that a processor's components
+ * carve their delay lines, histories and tables out of, so a whole instance's
+ * state is a single allocation with no pointer chasing between components.
+ *
+ * Components take their memory with allocate() from inside build(). The first
+ * build() can't know the total yet, so allocations that don't fit are served
+ * from temporary memory while the sizes are measured, then the block is
+ * allocated once at the exact total and the components are prepared again into
+ * it. Preparing again with the same or smaller needs reuses the block without
+ * allocating.
+ *
+ * Every allocation starts on its own cache line and is zeroed. The arena only
+ * hands out memory for trivial types, and owners must not be copied while they
+ * point into it.
+ */
+class StateArena
+{
+public:
+    /** Alignment of the block and of every allocation, one cache line. */
+    static constexpr size_t alignment = 64;
+    
+    StateArena() = default;
+    
+    /** Runs prepareComponents, which takes memory from this arena with allocate(),
+        growing the block to fit if needed. Any pointers handed out by earlier
+        builds are invalid afterwards. */
+    template<typename PrepareFunction>
+    void build(PrepareFunction&& prepareComponents)
+    {
+        building = true;
+        usedBytes = 0;
+        prepareComponents(*this);
+        
+        if (!overflowAllocations.empty())
+        {
+            // Measured, so allocate the exact total and hand out the final pointers
+            storage.reset(static_cast<std::byte*>(::operator new(usedBytes, std::align_val_t{alignment})));
+            capacity = usedBytes;
+            
+            usedBytes = 0;
+            prepareComponents(*this);
+            overflowAllocations.clear();
+        }
+        
+        building = false;
+    }
+    
+    /** Returns zeroed memory for count objects of type T. Only valid inside build(). */
+    template<typename T>
+    std::span<T> allocate(size_t count)
+    {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                      "StateArena only holds trivial types");
+        static_assert(alignof(T) <= alignment);
+        jassert(building);
+        
+        if (count == 0)
+            return {};
+        
+        const auto numBytes = roundUp(count * sizeof(T));
+        std::byte* memory = nullptr;
+        
+        if (usedBytes + numBytes <= capacity)
+        {
+            memory = storage.get() + usedBytes;
+        }
+        else
+        {
+            overflowAllocations.emplace_back(static_cast<std::byte*>(::operator new(numBytes, std::align_val_t{alignment})));
+            memory = overflowAllocations.back().get();
+        }
+        
+        usedBytes += numBytes;
+        std::memset(memory, 0, numBytes);
+        
+        return { reinterpret_cast<T*>(memory), count };
+    }
+    
+    /** Returns the number of bytes handed out by the last build(). */
+    size_t getSize() const { return usedBytes; }
+    
+    /** Returns the size of the block, which may be larger than getSize() after a
+        build that needed less than an earlier one. */
+    size_t getCapacity() const { return capacity; }
+    
+    /** Returns the start of the block. */
+    const std::byte* getData() const { return storage.get(); }
+    std::byte* getData() { return storage.get(); }
+
+private:
+    struct AlignedDelete
+    {
+        void operator()(std::byte* memory) const
+        {
+            ::operator delete(memory, std::align_val_t{alignment});
+        }
+    };
+    
+    using Block = std::unique_ptr<std::byte, AlignedDelete>;
+    
+    static constexpr size_t roundUp(size_t numBytes)
+    {
+        return (numBytes + alignment - 1) & ~(alignment - 1);
+    }
+    
+    Block storage;
+    size_t capacity = 0;
+    size_t usedBytes = 0;
+    bool building = false;
+    
+    // Memory for allocations that didn't fit while the first build was measuring
+    std::vector<Block> overflowAllocations;
+    
+    JUCE_DECLARE_NON_COPYABLE(StateArena)
+};
+
+} // namespace Utils
+} // namespace DSP
@@ -20,6 +20,18 @@ PluginProcessor::PluginProcessor()
 
     apvts.state.setProperty(Service::PresetManager::presetNameProperty, "", nullptr);
     presetManager = std::make_unique<Service::PresetManager>(apvts);
+
+    // Resolve the parameter values once so the audio thread never looks them up by name
+    for (size_t i = 0; i < dspParameterIDs.size(); ++i)
+    {
+        dspParameterValues[i] = apvts.getRawParameterValue(dspParameterIDs[i]);
+        jassert(dspParameterValues[i] != nullptr);
+    }
+
+    bypassParameter = apvts.getRawParameterValue("BYPASS");
+    jassert(bypassParameter != nullptr);
+
+    invalidateDSPParameters();
 }
 
 PluginProcessor::~PluginProcessor()
@@ -61,7 +73,13 @@ bool PluginProcessor::isMidiEffect() const
 
 double PluginProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return isUsingDoublePrecision() ? doubleDSPProcessor.getTailLengthSeconds()
+                                    : dspProcessor.getTailLengthSeconds();
+}
+
+size_t PluginProcessor::getDSPStateBytes() const
+{
+    return dspProcessor.getStateArena().getCapacity() + doubleDSPProcessor.getStateArena().getCapacity();
 }
 
 int PluginProcessor::getNumPrograms()
@@ -98,15 +116,29 @@ void PluginProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
     spec.sampleRate = sampleRate;
     spec.maximumBlockSize = static_cast<uint32>(samplesPerBlock);
     spec.numChannels = static_cast<uint32>(getTotalNumOutputChannels());
-    dspProcessor.prepare(spec);
+
+    if (isUsingDoublePrecision())
+    {
+        doubleDSPProcessor.prepare(spec);
+        setLatencySamples(doubleDSPProcessor.getLatencySamples());
+    }
+    else
+    {
+        dspProcessor.prepare(spec);
+        setLatencySamples(dspProcessor.getLatencySamples());
+    }
+
+    invalidateDSPParameters();
 
     MOONBASE_PREPARE_TO_PLAY (sampleRate, samplesPerBlock);
 }
 
 void PluginProcessor::releaseResources()
 {
-    // Reset the DSP processor
+    // Reset the DSP processors
     dspProcessor.reset();
+    doubleDSPProcessor.reset();
+    invalidateDSPParameters();
 }
 
 bool PluginProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
@@ -130,6 +162,25 @@ void PluginProcessor::processBlock (juce::AudioBuffer<float>& buffer,
                                     juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused (midiMessages);
+    processSamples (buffer, dspProcessor);
+}
+
+void PluginProcessor::processBlock (juce::AudioBuffer<double>& buffer,
+                                    juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused (midiMessages);
+    processSamples (buffer, doubleDSPProcessor);
+}
+
+bool PluginProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
+
+template<typename SampleType>
+void PluginProcessor::processSamples (juce::AudioBuffer<SampleType>& buffer,
+                                      DSP::Core::ChasmDSPProcessor<SampleType>& processor)
+{
     juce::ScopedNoDenormals noDenormals;
     
     auto totalNumInputChannels  = getTotalNumInputChannels();
@@ -139,39 +190,77 @@ void PluginProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    // Check if bypassed
-    bool isBypassed = *apvts.getRawParameterValue("BYPASS");
-    if (isBypassed)
-        return;    // Get parameter values and update DSP processor
-    float inputGain = *apvts.getRawParameterValue("INPUT_GAIN");
-    float outputGain = *apvts.getRawParameterValue("OUTPUT_GAIN");
-    float mix = *apvts.getRawParameterValue("MIX");
-    float delay = *apvts.getRawParameterValue("DELAY");
-    float brightness = *apvts.getRawParameterValue("BRIGHTNESS");
-    float character = *apvts.getRawParameterValue("CHARACTER");
-    float lowCut = *apvts.getRawParameterValue("LOW_CUT");
-    float highCut = *apvts.getRawParameterValue("HIGH_CUT");
-    float width = *apvts.getRawParameterValue("WIDTH");
-    bool limiterEnabled = *apvts.getRawParameterValue("LIMITER") > 0.5f;
-
-    // Update DSP processor parameters
-    // dspProcessor.setInputGain(inputGain);
-    // dspProcessor.setOutputGain(outputGain);
-    // dspProcessor.setMix(mix);
-    // dspProcessor.setDelay(delay);
-    // dspProcessor.setBrightness(brightness);
-    // dspProcessor.setCharacter(character);
-    // dspProcessor.setLowCut(lowCut);
-    // dspProcessor.setHighCut(highCut);
-    // dspProcessor.setWidth(width);
-    // dspProcessor.setLimiterEnabled(limiterEnabled);
-    dspProcessor.updateParameters(inputGain, outputGain, mix, delay, brightness,
-                                  character, lowCut, highCut, width, limiterEnabled);
+    // While bypassed the processor only delays the dry signal to match the reported latency
+    bool isBypassed = bypassParameter->load() > 0.5f;
+    processor.setBypassed (isBypassed);
+
+    // Update DSP processor parameters that changed since the last block
+    updateDSPParameters (processor);
 
     // Process the audio using function from
-    dspProcessor.processBlock(buffer);
+    processor.processBlock(buffer);
+
+    if (! isBypassed)
+        MOONBASE_PROCESS (buffer);
+}
+
+template<typename SampleType>
+void PluginProcessor::updateDSPParameters (DSP::Core::ChasmDSPProcessor<SampleType>& processor)
+{
+    for (size_t i = 0; i < dspParameterValues.size(); ++i)
+    {
+        float value = dspParameterValues[i]->load();
+
+        if (! forceFullUpdate && value == lastDSPParameterValues[i])
+            continue;
+
+        lastDSPParameterValues[i] = value;
+        setDSPParameter (processor, static_cast<DSPParameter>(i), value);
+    }
+
+    forceFullUpdate = false;
+}
 
-    MOONBASE_PROCESS (buffer);
+template<typename SampleType>
+void PluginProcessor::applyParameters (DSP::Core::ChasmDSPProcessor<SampleType>& processor) const
+{
+    for (size_t i = 0; i < dspParameterValues.size(); ++i)
+        setDSPParameter (processor, static_cast<DSPParameter>(i), dspParameterValues[i]->load());
+}
+
+template void PluginProcessor::applyParameters (DSP::Core::ChasmDSPProcessor<float>&) const;
+template void PluginProcessor::applyParameters (DSP::Core::ChasmDSPProcessor<double>&) const;
+
+template<typename SampleType>
+void PluginProcessor::setDSPParameter (DSP::Core::ChasmDSPProcessor<SampleType>& processor, DSPParameter parameter, float value)
+{
+    const auto sampleValue = static_cast<SampleType>(value);
+
+    switch (parameter)
+    {
+        case inputGainParameter:      processor.setInputGain(sampleValue); break;
+        case outputGainParameter:     processor.setOutputGain(sampleValue); break;
+        case mixParameter:            processor.setMix(sampleValue); break;
+        case delayParameter:          processor.setDelay(sampleValue); break;
+        case brightnessParameter:     processor.setBrightness(sampleValue); break;
+        case characterParameter:      processor.setCharacter(sampleValue); break;
+        case lowCutParameter:         processor.setLowCut(sampleValue); break;
+        case highCutParameter:        processor.setHighCut(sampleValue); break;
+        case widthParameter:          processor.setWidth(sampleValue); break;
+        case limiterParameter:        processor.setLimiterEnabled(value > 0.5f); break;
+        case softClipParameter:       processor.setSoftClipEnabled(value > 0.5f); break;
+        case multibandWidthParameter: processor.setMultibandWidthEnabled(value > 0.5f); break;
+        case lowWidthParameter:       processor.setBandWidth(0, sampleValue); break;
+        case lowMidWidthParameter:    processor.setBandWidth(1, sampleValue); break;
+        case highMidWidthParameter:   processor.setBandWidth(2, sampleValue); break;
+        case highWidthParameter:      processor.setBandWidth(3, sampleValue); break;
+        case numDSPParameters:        break;
+    }
+}
+
+void PluginProcessor::invalidateDSPParameters()
+{
+    forceFullUpdate = true;
 }
 
 //==============================================================================
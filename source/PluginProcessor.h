@@ -24,6 +24,8 @@ public:
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -47,6 +49,16 @@ public:
 
     Service::PresetManager& getPresetManager() { return *presetManager; }
 
+    /** Sends the current value of every DSP parameter to a processor, so one set of
+        parameters can drive processors outside the plugin, e.g. for offline renders.
+        Only reads the parameters, so it's safe to call for several processors at once. */
+    template<typename SampleType>
+    void applyParameters (DSP::Core::ChasmDSPProcessor<SampleType>& processor) const;
+
+    /** Returns the bytes the DSP processors hold in their state arenas, i.e. every
+        delay line and filter state of the prepared processor. */
+    size_t getDSPStateBytes() const;
+
     juce::AudioProcessorValueTreeState apvts;
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
     {
@@ -96,10 +108,35 @@ public:
             juce::ParameterID{"WIDTH", 1}, "Width", 
             juce::NormalisableRange<float>(0.0f, 200.0f, 0.1f), 100.0f));
         
+        // Multiband width (On/Off, Binary, N/A smoothing)
+        params.push_back(std::make_unique<juce::AudioParameterBool>(
+            juce::ParameterID{"MULTIBAND_WIDTH", 1}, "Multiband Width", false));
+        
+        // Per-band width (0 to 200%, Linear, 20ms smoothing in the enhancer)
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{"LOW_WIDTH", 1}, "Low Width", 
+            juce::NormalisableRange<float>(0.0f, 200.0f, 0.1f), 100.0f));
+        
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{"LOW_MID_WIDTH", 1}, "Low Mid Width", 
+            juce::NormalisableRange<float>(0.0f, 200.0f, 0.1f), 100.0f));
+        
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{"HIGH_MID_WIDTH", 1}, "High Mid Width", 
+            juce::NormalisableRange<float>(0.0f, 200.0f, 0.1f), 100.0f));
+        
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID{"HIGH_WIDTH", 1}, "High Width", 
+            juce::NormalisableRange<float>(0.0f, 200.0f, 0.1f), 100.0f));
+        
         // Limiter (On/Off, Binary, N/A smoothing)
         params.push_back(std::make_unique<juce::AudioParameterBool>(
             juce::ParameterID{"LIMITER", 1}, "Limiter", true));
         
+        // Oversampled soft clip ahead of the limiter (On/Off, Binary, N/A smoothing)
+        params.push_back(std::make_unique<juce::AudioParameterBool>(
+            juce::ParameterID{"SOFT_CLIP", 1}, "Soft Clip", false));
+        
         // Keep bypass for compatibility
         params.push_back(std::make_unique<juce::AudioParameterBool>(
             juce::ParameterID{"BYPASS", 1}, "Bypass", false));
@@ -108,10 +145,60 @@ public:
     }
 
 private:
+    /** Parameters forwarded to the DSP processor, in the order of dspParameterIDs. */
+    enum DSPParameter
+    {
+        inputGainParameter,
+        outputGainParameter,
+        mixParameter,
+        delayParameter,
+        brightnessParameter,
+        characterParameter,
+        lowCutParameter,
+        highCutParameter,
+        widthParameter,
+        limiterParameter,
+        softClipParameter,
+        multibandWidthParameter,
+        lowWidthParameter,
+        lowMidWidthParameter,
+        highMidWidthParameter,
+        highWidthParameter,
+        numDSPParameters
+    };
+
+    static constexpr std::array<const char*, numDSPParameters> dspParameterIDs {
+        "INPUT_GAIN", "OUTPUT_GAIN", "MIX", "DELAY", "BRIGHTNESS",
+        "CHARACTER", "LOW_CUT", "HIGH_CUT", "WIDTH", "LIMITER", "SOFT_CLIP",
+        "MULTIBAND_WIDTH", "LOW_WIDTH", "LOW_MID_WIDTH", "HIGH_MID_WIDTH", "HIGH_WIDTH"
+    };
+
+    /** Runs the DSP processor matching the host's processing precision. */
+    template<typename SampleType>
+    void processSamples (juce::AudioBuffer<SampleType>& buffer, DSP::Core::ChasmDSPProcessor<SampleType>& processor);
+
+    /** Pushes the parameters that changed since the last block to the DSP processor. */
+    template<typename SampleType>
+    void updateDSPParameters (DSP::Core::ChasmDSPProcessor<SampleType>& processor);
+
+    /** Sends one parameter value to the DSP processor. */
+    template<typename SampleType>
+    static void setDSPParameter (DSP::Core::ChasmDSPProcessor<SampleType>& processor, DSPParameter parameter, float value);
+
+    /** Forces every parameter to be pushed on the next block, e.g. after the processor was reset. */
+    void invalidateDSPParameters();
 
     std::unique_ptr<Service::PresetManager> presetManager;
-      // DSP Processor
+      // DSP Processors, only the one matching the processing precision is prepared
     DSP::FloatProcessor dspProcessor;
+    DSP::DoubleProcessor doubleDSPProcessor;
+
+    // Parameter values resolved once at construction, the values last sent to the processor,
+    // and whether the next block sends all of them regardless
+    std::array<std::atomic<float>*, numDSPParameters> dspParameterValues {};
+    std::array<float, numDSPParameters> lastDSPParameterValues {};
+    bool forceFullUpdate = true;
+    std::atomic<float>* bypassParameter = nullptr;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginProcessor)
 };
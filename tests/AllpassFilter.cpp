@@ -0,0 +1,317 @@
+#include <DSP/Filters/SchroederAllpassChain.h>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    constexpr double testSampleRate = 48000.0;
+    constexpr size_t numLanes = 2;
+
+    // Anything the chunked evaluation gets wrong is orders of magnitude above this
+    constexpr double tolerance = 1.0e-4;
+
+    /** The allpass recurrence y[n] = w[n - d] - g x[n], w[n] = x[n] + g w[n - d],
+        evaluated one sample at a time in double precision, with w read between
+        samples by linear interpolation and the delay gliding linearly during a ramp. */
+    struct ReferenceAllpass
+    {
+        double maxDelaySamples = 1.0;
+        double delay = 1.0;
+        double targetDelay = 1.0;
+        double delayStep = 0.0;
+        int rampSamplesRemaining = 0;
+        double feedback = 0.0;
+        std::array<std::vector<double>, numLanes> written;
+
+        explicit ReferenceAllpass (double maxDelayMs)
+            : maxDelaySamples (std::max (1.0, maxDelayMs * 0.001 * testSampleRate))
+        {
+        }
+
+        void setDelayTime (double delayMs, int rampSamples = 0)
+        {
+            targetDelay = juce::jlimit (1.0, maxDelaySamples, delayMs * 0.001 * testSampleRate);
+
+            if (rampSamples <= 0)
+            {
+                delay = targetDelay;
+                rampSamplesRemaining = 0;
+                return;
+            }
+
+            delayStep = (targetDelay - delay) / rampSamples;
+            rampSamplesRemaining = rampSamples;
+        }
+
+        void setFeedback (double newFeedback)
+        {
+            feedback = juce::jlimit (-0.99, 0.99, newFeedback);
+        }
+
+        template <typename SampleType>
+        void processFrame (SampleType* frame)
+        {
+            const auto position = static_cast<double> (written[0].size()) - delay;
+            const auto index = static_cast<juce::int64> (std::floor (position));
+            const auto fraction = position - static_cast<double> (index);
+
+            for (size_t lane = 0; lane < numLanes; ++lane)
+            {
+                auto& w = written[lane];
+                auto delayed = read (w, index);
+
+                if (fraction > 0.0)
+                    delayed += fraction * (read (w, index + 1) - delayed);
+
+                const auto input = static_cast<double> (frame[lane]);
+                frame[lane] = static_cast<SampleType> (delayed - feedback * input);
+                w.push_back (input + feedback * delayed);
+            }
+
+            if (rampSamplesRemaining > 0)
+            {
+                delay += delayStep;
+
+                if (--rampSamplesRemaining == 0)
+                    delay = targetDelay;
+            }
+        }
+
+        static double read (const std::vector<double>& w, juce::int64 index)
+        {
+            return index >= 0 ? w[static_cast<size_t> (index)] : 0.0;
+        }
+    };
+
+    /** A per-sample model of SchroederAllpassChain: four reference stages, with the
+        chain's delay ratios and character mapping, updated once per block the way
+        the chain updates its stages. */
+    template <typename SampleType>
+    struct ReferenceChain
+    {
+        static constexpr std::array<SampleType, 4> delayScales { SampleType (0.41), SampleType (0.66), SampleType (0.97), SampleType (1.25) };
+
+        std::vector<ReferenceAllpass> stages;
+        DSP::Utils::ParameterSmoother<SampleType> delayTimeSmoother;
+        DSP::Utils::ParameterSmoother<SampleType> characterSmoother;
+        bool parametersNeedUpdate = true;
+
+        ReferenceChain()
+        {
+            const std::array<double, 4> initialDelays { 12.3, 19.7, 29.1, 37.4 };
+
+            for (size_t i = 0; i < delayScales.size(); ++i)
+            {
+                stages.emplace_back (std::min (static_cast<double> (SampleType (100) * delayScales[i]), 100.0));
+                stages.back().setDelayTime (initialDelays[i]);
+                stages.back().setFeedback (static_cast<double> (SampleType (0.7)));
+            }
+
+            delayTimeSmoother.prepare (testSampleRate, 50.0);
+            characterSmoother.prepare (testSampleRate, 10.0);
+            delayTimeSmoother.reset (SampleType (30));
+            characterSmoother.reset (SampleType (1));
+        }
+
+        void setDelayTime (SampleType delayMs) { delayTimeSmoother.setTargetValue (juce::jlimit (SampleType (1), SampleType (100), delayMs)); }
+        void setCharacter (SampleType character) { characterSmoother.setTargetValue (juce::jlimit (SampleType (0.1), SampleType (10), character)); }
+
+        void process (SampleType* frames, int numFrames)
+        {
+            if (parametersNeedUpdate || delayTimeSmoother.isSmoothing() || characterSmoother.isSmoothing())
+            {
+                const auto delayMs = delayTimeSmoother.skip (numFrames);
+                const auto character = characterSmoother.skip (numFrames);
+                const auto feedback = juce::jlimit (SampleType (0.1), SampleType (0.9),
+                                                    SampleType (0.3) + SampleType (0.6) * DSP::Utils::DSPUtils::fastLog (character) * static_cast<SampleType> (0.4342944819032518));
+
+                for (size_t i = 0; i < stages.size(); ++i)
+                {
+                    stages[i].setDelayTime (static_cast<double> (delayMs * delayScales[i]), numFrames);
+                    stages[i].setFeedback (static_cast<double> (feedback));
+                }
+
+                parametersNeedUpdate = false;
+            }
+
+            for (int i = 0; i < numFrames; ++i)
+                for (auto& stage : stages)
+                    stage.processFrame (frames + static_cast<size_t> (i) * numLanes);
+        }
+    };
+
+    template <typename SampleType>
+    std::vector<SampleType> makeNoise (int numFrames)
+    {
+        std::vector<SampleType> frames (static_cast<size_t> (numFrames) * numLanes);
+        juce::Random random (5);
+
+        for (auto& sample : frames)
+            sample = static_cast<SampleType> (random.nextFloat() * 2.0f - 1.0f);
+
+        return frames;
+    }
+
+    template <typename SampleType>
+    double maxDifference (const std::vector<SampleType>& a, const std::vector<SampleType>& b)
+    {
+        double difference = 0.0;
+
+        for (size_t i = 0; i < a.size(); ++i)
+            difference = std::max (difference, std::abs (static_cast<double> (a[i]) - static_cast<double> (b[i])));
+
+        return difference;
+    }
+
+    // Block sizes that land chunk and ramp boundaries all over the place
+    constexpr std::array<int, 6> blockSizes { 1, 13, 64, 100, 37, 250 };
+}
+
+TEMPLATE_TEST_CASE ("Chunked allpass matches the per-sample recurrence", "[allpass]", float, double)
+{
+    constexpr double maxDelayMs = 5.0;
+    constexpr int numFrames = 24000;
+
+    DSP::Filters::AllpassFilter<TestType, numLanes> filter;
+    ReferenceAllpass reference (maxDelayMs);
+
+    filter.prepare (testSampleRate, maxDelayMs);
+
+    auto frames = makeNoise<TestType> (numFrames);
+    auto expected = frames;
+
+    SECTION ("with steady delays")
+    {
+        filter.setFeedback (TestType (0.7));
+        reference.setFeedback (static_cast<double> (TestType (0.7)));
+
+        // Delays in samples on both sides of the chunk length
+        const std::array<double, 8> delays { 1.5, 2.0, 3.25, 17.0, 63.5, 64.0, 65.7, 200.0 };
+        int position = 0;
+
+        for (size_t i = 0; position < numFrames; ++i)
+        {
+            const auto delayMs = delays[(i / blockSizes.size()) % delays.size()] / (0.001 * testSampleRate);
+            const auto numToProcess = std::min (blockSizes[i % blockSizes.size()], numFrames - position);
+
+            // Jump to a new delay every few blocks
+            if (i % blockSizes.size() == 0)
+            {
+                filter.setDelayTime (delayMs);
+                reference.setDelayTime (delayMs);
+            }
+
+            const auto offset = static_cast<size_t> (position) * numLanes;
+            filter.process (frames.data() + offset, frames.data() + offset, numToProcess);
+
+            for (int frame = 0; frame < numToProcess; ++frame)
+                reference.processFrame (expected.data() + offset + static_cast<size_t> (frame) * numLanes);
+
+            position += numToProcess;
+        }
+
+        CHECK (maxDifference (frames, expected) < tolerance);
+    }
+
+    SECTION ("with delays ramping across chunk and block boundaries")
+    {
+        filter.setFeedback (TestType (-0.6));
+        reference.setFeedback (static_cast<double> (TestType (-0.6)));
+
+        // Targets and ramp lengths, restarted now and then before a ramp has finished
+        const std::array<double, 7> delays { 3.0, 70.0, 5.5, 180.0, 40.0, 1.5, 66.0 };
+        const std::array<int, 5> ramps { 0, 7, 64, 150, 500 };
+        int position = 0;
+
+        for (size_t i = 0; position < numFrames; ++i)
+        {
+            const auto numToProcess = std::min (blockSizes[i % blockSizes.size()], numFrames - position);
+
+            if (i % 4 == 0)
+            {
+                const auto delayMs = delays[(i / 4) % delays.size()] / (0.001 * testSampleRate);
+                const auto rampSamples = ramps[(i / 4) % ramps.size()];
+
+                filter.setDelayTime (delayMs, rampSamples);
+                reference.setDelayTime (delayMs, rampSamples);
+            }
+
+            const auto offset = static_cast<size_t> (position) * numLanes;
+            filter.process (frames.data() + offset, frames.data() + offset, numToProcess);
+
+            for (int frame = 0; frame < numToProcess; ++frame)
+                reference.processFrame (expected.data() + offset + static_cast<size_t> (frame) * numLanes);
+
+            position += numToProcess;
+        }
+
+        CHECK (maxDifference (frames, expected) < tolerance);
+    }
+}
+
+TEMPLATE_TEST_CASE ("Allpass chain matches a per-sample reference", "[allpass]", float, double)
+{
+    constexpr int numFrames = 48000;
+
+    DSP::Filters::SchroederAllpassChain<TestType, numLanes> chain;
+    ReferenceChain<TestType> reference;
+    chain.prepare (testSampleRate);
+
+    auto frames = makeNoise<TestType> (numFrames);
+    auto expected = frames;
+
+    auto render = [&] (auto&& automate)
+    {
+        int position = 0;
+
+        for (size_t i = 0; position < numFrames; ++i)
+        {
+            automate (i);
+
+            const auto numToProcess = std::min (blockSizes[i % blockSizes.size()], numFrames - position);
+            const auto offset = static_cast<size_t> (position) * numLanes;
+
+            chain.process (frames.data() + offset, frames.data() + offset, numToProcess);
+            reference.process (expected.data() + offset, numToProcess);
+
+            position += numToProcess;
+        }
+    };
+
+    SECTION ("with steady settings")
+    {
+        // Short enough that the first stage's chunks are only a few frames long
+        chain.setDelayTime (TestType (2));
+        chain.setCharacter (TestType (3));
+        reference.setDelayTime (TestType (2));
+        reference.setCharacter (TestType (3));
+
+        render ([] (size_t) {});
+        CHECK (maxDifference (frames, expected) < tolerance);
+    }
+
+    SECTION ("with automated delay and character")
+    {
+        const std::array<TestType, 6> delays { TestType (1), TestType (40), TestType (3), TestType (90), TestType (1.5), TestType (20) };
+        const std::array<TestType, 3> characters { TestType (0.5), TestType (6), TestType (2) };
+
+        render ([&] (size_t i)
+        {
+            if (i % 40 != 0)
+                return;
+
+            const auto delayMs = delays[(i / 40) % delays.size()];
+            const auto character = characters[(i / 40) % characters.size()];
+
+            chain.setDelayTime (delayMs);
+            chain.setCharacter (character);
+            reference.setDelayTime (delayMs);
+            reference.setCharacter (character);
+        });
+
+        CHECK (maxDifference (frames, expected) < tolerance);
+    }
+}
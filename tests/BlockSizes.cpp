@@ -0,0 +1,82 @@
+#include "helpers/processor_fixture.h"
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace ProcessorFixture;
+
+namespace
+{
+    constexpr int testNumSamples = 150000;
+
+    // Chunking only changes where control blocks start, so renders may differ by rounding at most
+    constexpr float tolerance = 1.0e-6f;
+
+    /** Renders noise through a processor with settled, non-default parameters, handing
+        it to processBlock in blocks of the sizes produced by nextBlockSize. */
+    template <typename BlockSizeFunction>
+    juce::AudioBuffer<float> render (BlockSizeFunction&& nextBlockSize)
+    {
+        DSP::Core::ChasmDSPProcessor<float> processor;
+        prepareProcessor (processor, { .outputGainDb = -3.0, .delayMs = 45.0, .brightnessDb = 3.0,
+                                       .lowCutPercent = 20.0, .widthPercent = 140.0, .softClipEnabled = true });
+
+        // Let every smoother land on its target, so only the block sizes differ between renders
+        juce::AudioBuffer<float> silence (2, testBlockSize);
+
+        for (int block = 0; block < 100; ++block)
+        {
+            silence.clear();
+            processor.processBlock (silence);
+        }
+
+        juce::AudioBuffer<float> output (2, testNumSamples);
+        juce::Random random (7);
+        fillWithNoise (output, random);
+
+        for (int startSample = 0; startSample < testNumSamples;)
+        {
+            const auto numSamples = juce::jmin (nextBlockSize(), testNumSamples - startSample);
+            juce::AudioBuffer<float> block (output.getArrayOfWritePointers(), 2, startSample, numSamples);
+            processor.processBlock (block);
+            startSample += numSamples;
+        }
+
+        return output;
+    }
+
+    float maxDifference (const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        float difference = 0.0f;
+
+        for (int channel = 0; channel < a.getNumChannels(); ++channel)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                difference = juce::jmax (difference, std::abs (a.getSample (channel, i) - b.getSample (channel, i)));
+
+        return difference;
+    }
+}
+
+TEST_CASE ("Output does not depend on the host block size", "[blocksize]")
+{
+    const auto reference = render ([] { return testBlockSize; });
+
+    REQUIRE (reference.getMagnitude (0, testNumSamples) > 0.0f);
+
+    SECTION ("Fixed block sizes from 1 to 65536")
+    {
+        for (int blockSize : { 1, 7, 31, 32, 33, 100, 1024, 4096, 65536 })
+        {
+            INFO ("Block size " << blockSize);
+            CHECK (maxDifference (reference, render ([blockSize] { return blockSize; })) <= tolerance);
+        }
+    }
+
+    SECTION ("Block size changing on every call")
+    {
+        juce::Random random (3);
+        const std::vector<int> sizes { 1, 2, 15, 64, 128, 333, 480, 512, 2048, 8192 };
+
+        CHECK (maxDifference (reference, render ([&] { return sizes[(size_t) random.nextInt ((int) sizes.size())]; })) <= tolerance);
+    }
+}
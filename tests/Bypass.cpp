@@ -0,0 +1,81 @@
+#include "helpers/processor_fixture.h"
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+using namespace ProcessorFixture;
+
+TEST_CASE ("Bypass delays the dry signal by the reported latency", "[bypass]")
+{
+    DSP::Core::ChasmDSPProcessor<float> processor;
+    prepareProcessor (processor, wetSettings);
+    processor.setBypassed (true);
+
+    const auto latency = processor.getLatencySamples();
+    REQUIRE (latency > 0);
+
+    // An impulse near the end of a block, so the delayed copy crosses into the next one
+    constexpr int impulsePosition = testBlockSize - 10;
+    juce::AudioBuffer<float> buffer (2, testBlockSize);
+    std::vector<float> output;
+
+    for (int block = 0; block < 4; ++block)
+    {
+        buffer.clear();
+
+        if (block == 0)
+        {
+            buffer.setSample (0, impulsePosition, 1.0f);
+            buffer.setSample (1, impulsePosition, -0.5f);
+        }
+
+        processor.processBlock (buffer);
+
+        for (int i = 0; i < testBlockSize; ++i)
+        {
+            output.push_back (buffer.getSample (0, i));
+            CHECK (buffer.getSample (1, i) == -0.5f * buffer.getSample (0, i));
+        }
+    }
+
+    for (size_t i = 0; i < output.size(); ++i)
+        CHECK (output[i] == (i == static_cast<size_t> (impulsePosition + latency) ? 1.0f : 0.0f));
+}
+
+TEST_CASE ("Leaving bypass starts from silence", "[bypass]")
+{
+    DSP::Core::ChasmDSPProcessor<float> processor;
+    prepareProcessor (processor, wetSettings);
+
+    juce::AudioBuffer<float> buffer (2, testBlockSize);
+    juce::Random random (5);
+
+    // Fill every delay line and the allpass tail with audio
+    for (int block = 0; block < 20; ++block)
+    {
+        fillWithNoise (buffer, random);
+        processor.processBlock (buffer);
+    }
+
+    processor.setBypassed (true);
+
+    for (int block = 0; block < 4; ++block)
+    {
+        fillWithNoise (buffer, random);
+        processor.processBlock (buffer);
+    }
+
+    // Nothing from before or during the bypass may come back out
+    processor.setBypassed (false);
+
+    for (int block = 0; block < 4; ++block)
+    {
+        buffer.clear();
+        processor.processBlock (buffer);
+        CHECK (buffer.getMagnitude (0, testBlockSize) == 0.0f);
+    }
+
+    // And new input is processed as usual
+    fillWithNoise (buffer, random);
+    processor.processBlock (buffer);
+    CHECK (buffer.getMagnitude (0, testBlockSize) > 0.0f);
+}
@@ -0,0 +1,92 @@
+#include <DSP/Filters/LinkwitzRileyCrossover.h>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    constexpr double testSampleRate = 48000.0;
+
+    /** Runs a sine through the bank and returns the steady-state RMS of each band and of their sum, in dB. */
+    template <typename SampleType>
+    std::array<double, 5> measureBands (double frequency)
+    {
+        DSP::Filters::LinkwitzRileyCrossoverBank<SampleType> crossover;
+        crossover.prepare (testSampleRate);
+
+        constexpr int numFrames = 48000;
+        constexpr size_t numBands = DSP::Filters::LinkwitzRileyCrossoverBank<SampleType>::numBands;
+        std::vector<SampleType> frames (numFrames * numBands);
+
+        for (int i = 0; i < numFrames; ++i)
+            for (size_t band = 0; band < numBands; ++band)
+                frames[static_cast<size_t> (i) * numBands + band] = static_cast<SampleType> (std::sin (juce::MathConstants<double>::twoPi * frequency * i / testSampleRate));
+
+        crossover.processFrames (frames.data(), numFrames);
+
+        std::array<double, 5> energy {};
+
+        for (int i = numFrames / 2; i < numFrames; ++i)
+        {
+            double sum = 0.0;
+
+            for (size_t band = 0; band < numBands; ++band)
+            {
+                const auto sample = static_cast<double> (frames[static_cast<size_t> (i) * numBands + band]);
+                energy[band] += sample * sample;
+                sum += sample;
+            }
+
+            energy[numBands] += sum * sum;
+        }
+
+        // A unit sine has a mean square of 1/2
+        const double reference = 0.5 * (numFrames / 2);
+        std::array<double, 5> levels {};
+
+        for (size_t i = 0; i < levels.size(); ++i)
+            levels[i] = 10.0 * std::log10 (std::max (energy[i], 1e-30) / reference);
+
+        return levels;
+    }
+}
+
+TEMPLATE_TEST_CASE ("Linkwitz-Riley crossover bank", "[crossover]", float, double)
+{
+    SECTION ("Bands sum to a flat response")
+    {
+        for (double frequency : { 40.0, 150.0, 450.0, 1000.0, 2500.0, 5000.0, 15000.0 })
+            CHECK (std::abs (measureBands<TestType> (frequency)[4]) < 0.01);
+    }
+
+    SECTION ("Adjacent bands cross at -6 dB")
+    {
+        const auto atLowCrossover = measureBands<TestType> (150.0);
+        CHECK (std::abs (atLowCrossover[0] + 6.02) < 0.1);
+        CHECK (std::abs (atLowCrossover[1] + 6.02) < 0.1);
+
+        const auto atHighCrossover = measureBands<TestType> (5000.0);
+        CHECK (std::abs (atHighCrossover[2] + 6.02) < 0.1);
+        CHECK (std::abs (atHighCrossover[3] + 6.02) < 0.1);
+    }
+
+    SECTION ("Each band passes its own range and rejects the others")
+    {
+        const std::array<double, 4> bandCentres { 40.0, 400.0, 2200.0, 15000.0 };
+
+        for (size_t band = 0; band < bandCentres.size(); ++band)
+        {
+            const auto levels = measureBands<TestType> (bandCentres[band]);
+
+            for (size_t other = 0; other < bandCentres.size(); ++other)
+            {
+                if (other == band)
+                    CHECK (levels[other] > -1.0);
+                else
+                    CHECK (levels[other] < -20.0);
+            }
+        }
+    }
+}
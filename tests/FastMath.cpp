@@ -0,0 +1,142 @@
+#include <DSP/Utils/DSPUtils.h>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
+{
+    using DSP::Utils::DSPUtils;
+
+    template <typename SampleType>
+    struct FastMathBounds;
+
+    template <>
+    struct FastMathBounds<float>
+    {
+        static constexpr double exp = 5e-6;
+        static constexpr double log = 1e-5;
+        static constexpr double tanh = 2e-6;
+    };
+
+    template <>
+    struct FastMathBounds<double>
+    {
+        static constexpr double exp = 2e-8;
+        static constexpr double log = 2e-9;
+        static constexpr double tanh = 5e-8;
+    };
+
+    template <typename SampleType>
+    std::vector<SampleType> linearRange (double start, double end, int numPoints)
+    {
+        std::vector<SampleType> values (static_cast<size_t> (numPoints));
+
+        for (int i = 0; i < numPoints; ++i)
+            values[static_cast<size_t> (i)] = static_cast<SampleType> (start + (end - start) * i / (numPoints - 1));
+
+        return values;
+    }
+
+    double relativeError (double approximation, double reference)
+    {
+        return std::abs (approximation - reference) / std::max (std::abs (reference), 1e-300);
+    }
+}
+
+TEMPLATE_TEST_CASE ("Fast math error bounds", "[fastmath]", float, double)
+{
+    using Bounds = FastMathBounds<TestType>;
+
+    SECTION ("fastExp")
+    {
+        double maxError = 0.0;
+
+        for (auto x : linearRange<TestType> (-80.0, 80.0, 100001))
+            maxError = std::max (maxError, relativeError (DSPUtils::fastExp (x), std::exp (static_cast<double> (x))));
+
+        CHECK (maxError < Bounds::exp);
+    }
+
+    SECTION ("fastLog")
+    {
+        double maxError = 0.0;
+
+        for (auto exponent : linearRange<double> (-30.0, 30.0, 100001))
+        {
+            auto x = static_cast<TestType> (std::pow (2.0, exponent));
+            maxError = std::max (maxError, std::abs (DSPUtils::fastLog (x) - std::log (static_cast<double> (x))));
+        }
+
+        CHECK (maxError < Bounds::log);
+    }
+
+    SECTION ("fastTanh")
+    {
+        double maxError = 0.0;
+
+        for (auto x : linearRange<TestType> (-25.0, 25.0, 100001))
+            maxError = std::max (maxError, relativeError (DSPUtils::fastTanh (x), std::tanh (static_cast<double> (x))));
+
+        CHECK (maxError < Bounds::tanh);
+        CHECK (DSPUtils::fastTanh (TestType (0)) == TestType (0));
+
+        // Saturates without overshooting, within an ulp of +-1
+        constexpr auto epsilon = std::numeric_limits<TestType>::epsilon();
+        CHECK (DSPUtils::fastTanh (TestType (100)) <= TestType (1));
+        CHECK (DSPUtils::fastTanh (TestType (100)) >= TestType (1) - epsilon);
+        CHECK (DSPUtils::fastTanh (TestType (-100)) == -DSPUtils::fastTanh (TestType (100)));
+    }
+
+    SECTION ("fastDbToGain and fastGainToDb")
+    {
+        double maxError = 0.0;
+
+        for (auto db : linearRange<TestType> (-120.0, 24.0, 10001))
+        {
+            auto gain = DSPUtils::fastDbToGain (db);
+            maxError = std::max (maxError, relativeError (gain, std::pow (10.0, static_cast<double> (db) / 20.0)));
+            CHECK (std::abs (DSPUtils::fastGainToDb (gain) - db) < TestType (1e-3));
+        }
+
+        CHECK (maxError < Bounds::exp);
+    }
+
+    SECTION ("fastPow")
+    {
+        for (auto base : { TestType (0.5), TestType (2), TestType (10), TestType (100) })
+            for (auto exponent : linearRange<TestType> (-2.0, 2.0, 101))
+                CHECK (relativeError (DSPUtils::fastPow (base, exponent), std::pow (static_cast<double> (base), static_cast<double> (exponent))) < 1e-5);
+    }
+}
+
+TEMPLATE_TEST_CASE ("Fast math array versions match the scalar versions", "[fastmath]", float, double)
+{
+    // The array loops may be vectorised with different instruction selection,
+    // so allow a few ulp of difference
+    constexpr double tolerance = 4.0 * std::numeric_limits<TestType>::epsilon();
+
+    auto input = linearRange<TestType> (-10.0, 10.0, 1027);
+    auto positive = linearRange<TestType> (1e-3, 1e3, 1027);
+    std::vector<TestType> output (input.size());
+    const auto numSamples = static_cast<int> (input.size());
+
+    DSPUtils::fastExp (input.data(), output.data(), numSamples);
+    for (size_t i = 0; i < input.size(); ++i)
+        REQUIRE (relativeError (output[i], DSPUtils::fastExp (input[i])) <= tolerance);
+
+    DSPUtils::fastDbToGain (input.data(), output.data(), numSamples);
+    for (size_t i = 0; i < input.size(); ++i)
+        REQUIRE (relativeError (output[i], DSPUtils::fastDbToGain (input[i])) <= tolerance);
+
+    DSPUtils::fastLog (positive.data(), output.data(), numSamples);
+    for (size_t i = 0; i < positive.size(); ++i)
+        REQUIRE (std::abs (output[i] - DSPUtils::fastLog (positive[i])) <= tolerance * 8.0);
+
+    // In place
+    output = input;
+    DSPUtils::fastTanh (output.data(), output.data(), numSamples);
+    for (size_t i = 0; i < input.size(); ++i)
+        REQUIRE (relativeError (output[i], DSPUtils::fastTanh (input[i])) <= tolerance);
+}
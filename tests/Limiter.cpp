@@ -0,0 +1,281 @@
+#include <DSP/Effects/Limiter.h>
+#include <DSP/Effects/SoftClipper.h>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
+{
+    constexpr double testSampleRate = 48000.0;
+    constexpr int testBlockSize = 512;
+    constexpr int numSamples = 48000;
+
+    // The limiter's default ceiling, -0.3 dBTP
+    const double ceiling = juce::Decibels::decibelsToGain (-0.3);
+
+    using Signal = std::array<std::vector<double>, 2>;
+
+    /** Runs a stereo signal through the soft clipper, if given, and the limiter in
+        blocks, the way ChasmDSPProcessor does. */
+    template <typename SampleType>
+    Signal process (const Signal& input, bool softClipEnabled = false)
+    {
+        const juce::dsp::ProcessSpec spec { testSampleRate, testBlockSize, 2 };
+
+        DSP::Effects::OversampledSoftClipper<SampleType> softClipper;
+        DSP::Effects::LookaheadLimiter<SampleType> limiter;
+        softClipper.prepare (spec);
+        softClipper.setEnabled (softClipEnabled);
+        limiter.prepare (spec);
+
+        const auto length = static_cast<int> (input[0].size());
+        juce::AudioBuffer<SampleType> buffer (2, testBlockSize);
+        Signal output;
+
+        for (int start = 0; start < length; start += testBlockSize)
+        {
+            const auto blockLength = std::min (testBlockSize, length - start);
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < blockLength; ++i)
+                    buffer.setSample (channel, i, static_cast<SampleType> (input[static_cast<size_t> (channel)][static_cast<size_t> (start + i)]));
+
+            softClipper.process (buffer.getArrayOfWritePointers(), 2, blockLength);
+            limiter.process (buffer.getArrayOfWritePointers(), 2, blockLength);
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < blockLength; ++i)
+                    output[static_cast<size_t> (channel)].push_back (static_cast<double> (buffer.getSample (channel, i)));
+        }
+
+        return output;
+    }
+
+    double getSamplePeak (const Signal& signal)
+    {
+        double peak = 0.0;
+
+        for (const auto& channel : signal)
+            for (auto sample : channel)
+                peak = std::max (peak, std::abs (sample));
+
+        return peak;
+    }
+
+    /** Returns the true peak as ITU-R BS.1770 Annex 2 defines it: the peak of the
+        signal upsampled 4x with the standard's 48 tap interpolator. */
+    double getTruePeak (const Signal& signal)
+    {
+        constexpr std::array<std::array<double, 12>, 4> phases {{
+            { 0.0017089843750, 0.0109863281250, -0.0196533203125, 0.0332031250000, -0.0594482421875, 0.1373291015625,
+              0.9721679687500, -0.1022949218750, 0.0476074218750, -0.0266113281250, 0.0148925781250, -0.0083007812500 },
+            { -0.0291748046875, 0.0292968750000, -0.0517578125000, 0.0891113281250, -0.1665039062500, 0.4650878906250,
+              0.7797851562500, -0.2003173828125, 0.1015625000000, -0.0582275390625, 0.0330810546875, -0.0189208984375 },
+            { -0.0189208984375, 0.0330810546875, -0.0582275390625, 0.1015625000000, -0.2003173828125, 0.7797851562500,
+              0.4650878906250, -0.1665039062500, 0.0891113281250, -0.0517578125000, 0.0292968750000, -0.0291748046875 },
+            { -0.0083007812500, 0.0148925781250, -0.0266113281250, 0.0476074218750, -0.1022949218750, 0.9721679687500,
+              0.1373291015625, -0.0594482421875, 0.0332031250000, -0.0196533203125, 0.0109863281250, 0.0017089843750 }
+        }};
+
+        auto peak = getSamplePeak (signal);
+
+        for (const auto& channel : signal)
+        {
+            for (size_t i = phases[0].size(); i < channel.size(); ++i)
+            {
+                for (const auto& taps : phases)
+                {
+                    double sum = 0.0;
+
+                    for (size_t tap = 0; tap < taps.size(); ++tap)
+                        sum += taps[tap] * channel[i - tap];
+
+                    peak = std::max (peak, std::abs (sum));
+                }
+            }
+        }
+
+        return peak;
+    }
+
+    Signal makeSine (double frequency, double amplitude, double phase)
+    {
+        Signal signal;
+
+        for (auto& channel : signal)
+            for (int i = 0; i < numSamples; ++i)
+                channel.push_back (amplitude * std::sin (juce::MathConstants<double>::twoPi * frequency * i / testSampleRate + phase));
+
+        return signal;
+    }
+
+    Signal makeNoise (double amplitude)
+    {
+        Signal signal;
+        juce::Random random (17);
+
+        for (auto& channel : signal)
+            for (int i = 0; i < numSamples; ++i)
+                channel.push_back (amplitude * (random.nextDouble() * 2.0 - 1.0));
+
+        return signal;
+    }
+
+    /** A smooth pulse, quiet enough for the soft clipper to pass it unchanged. */
+    Signal makePulse (int position, int width, double amplitude)
+    {
+        Signal signal;
+
+        for (auto& channel : signal)
+        {
+            channel.assign (4096, 0.0);
+
+            for (int i = 0; i <= width; ++i)
+                channel[static_cast<size_t> (position - width / 2 + i)] = amplitude * (0.5 - 0.5 * std::cos (juce::MathConstants<double>::twoPi * i / width));
+        }
+
+        return signal;
+    }
+
+    /** Returns the centre of mass of a channel's absolute values, in samples. */
+    double getCentre (const std::vector<double>& samples)
+    {
+        double sum = 0.0, weightedSum = 0.0;
+
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            sum += std::abs (samples[i]);
+            weightedSum += std::abs (samples[i]) * static_cast<double> (i);
+        }
+
+        return weightedSum / sum;
+    }
+}
+
+TEMPLATE_TEST_CASE ("Lookahead limiter is brickwall at the ceiling", "[limiter]", float, double)
+{
+    // The output is rounded to the sample type after the final clamp
+    const auto sampleTolerance = static_cast<double> (std::numeric_limits<TestType>::epsilon());
+
+    // The meter sums 12 rounded samples, each rounded after the gain was applied
+    const auto truePeakTolerance = 32.0 * sampleTolerance;
+
+    SECTION ("Hot noise")
+    {
+        const auto output = process<TestType> (makeNoise (4.0));
+
+        CHECK (getSamplePeak (output) <= ceiling + sampleTolerance);
+        CHECK (getTruePeak (output) <= ceiling + truePeakTolerance);
+    }
+
+    SECTION ("Inter-sample peaks between samples below the ceiling")
+    {
+        // At a quarter of the sample rate and 45 degrees, every sample sits at
+        // 0.95 but the waveform peaks 3 dB higher between them
+        const auto output = process<TestType> (makeSine (testSampleRate / 4.0, 0.95 * std::sqrt (2.0), juce::MathConstants<double>::pi / 4.0));
+
+        CHECK (getSamplePeak (output) <= ceiling + sampleTolerance);
+        CHECK (getTruePeak (output) <= ceiling + truePeakTolerance);
+    }
+
+    SECTION ("Loud high tones")
+    {
+        for (double frequency : { 997.0, 7001.0, 11025.0, 17000.0 })
+        {
+            const auto output = process<TestType> (makeSine (frequency, 2.0, 0.3));
+
+            CHECK (getSamplePeak (output) <= ceiling + sampleTolerance);
+            CHECK (getTruePeak (output) <= ceiling + truePeakTolerance);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE ("Limiter and soft clipper delay by exactly their latency", "[limiter]", float, double)
+{
+    const juce::dsp::ProcessSpec spec { testSampleRate, testBlockSize, 2 };
+
+    DSP::Effects::OversampledSoftClipper<TestType> softClipper;
+    DSP::Effects::LookaheadLimiter<TestType> limiter;
+    softClipper.prepare (spec);
+    limiter.prepare (spec);
+
+    const auto latency = softClipper.getLatencySamples() + limiter.getLatencySamples();
+    REQUIRE (limiter.getLatencySamples() > 0);
+
+    SECTION ("Clipper off, an impulse arrives intact")
+    {
+        Signal impulse;
+
+        for (auto& channel : impulse)
+        {
+            channel.assign (4096, 0.0);
+            channel[1000] = 0.5;
+        }
+
+        const auto output = process<TestType> (impulse);
+
+        for (const auto& channel : output)
+        {
+            for (size_t i = 0; i < channel.size(); ++i)
+            {
+                if (i == static_cast<size_t> (1000 + latency))
+                    CHECK (channel[i] == 0.5);
+                else
+                    CHECK (channel[i] == 0.0);
+            }
+        }
+    }
+
+    SECTION ("Clipper on, a pulse arrives centred on the same delay")
+    {
+        // The oversampling filters spread an impulse out, so check where a smooth
+        // pulse's energy arrives instead of where a single sample lands
+        const auto input = makePulse (1000, 64, 0.01);
+        const auto output = process<TestType> (input, true);
+
+        for (size_t channel = 0; channel < 2; ++channel)
+            CHECK (std::abs (getCentre (output[channel]) - getCentre (input[channel]) - latency) < 0.5);
+    }
+}
+
+TEMPLATE_TEST_CASE ("Enabling the limiter limits the audio it has already delayed", "[limiter]", float, double)
+{
+    DSP::Effects::LookaheadLimiter<TestType> limiter;
+    limiter.prepare ({ testSampleRate, testBlockSize, 2 });
+    limiter.setEnabled (false);
+
+    const auto input = makeNoise (2.0);
+    juce::AudioBuffer<TestType> buffer (2, testBlockSize);
+
+    auto processBlock = [&] (int block)
+    {
+        for (int channel = 0; channel < 2; ++channel)
+            for (int i = 0; i < testBlockSize; ++i)
+                buffer.setSample (channel, i, static_cast<TestType> (input[static_cast<size_t> (channel)][static_cast<size_t> (block * testBlockSize + i)]));
+
+        limiter.processBlock (buffer);
+    };
+
+    // Fill the delay with hot noise the limiter has not touched
+    for (int block = 0; block < 8; ++block)
+        processBlock (block);
+
+    limiter.setEnabled (true);
+    processBlock (8);
+
+    REQUIRE (limiter.getLatencySamples() < testBlockSize);
+
+    // A sample sitting on the ceiling was held there by the final clamp rather than
+    // the gain, so the first block after enabling must have none, as in steady state
+    int numClamped = 0;
+
+    for (int channel = 0; channel < 2; ++channel)
+        for (int i = 0; i < testBlockSize; ++i)
+            if (std::abs (buffer.getSample (channel, i)) >= static_cast<TestType> (ceiling))
+                ++numClamped;
+
+    CHECK (numClamped == 0);
+}
@@ -0,0 +1,152 @@
+#include "helpers/processor_fixture.h"
+#include <DSP/ChasmDSP.h>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace ProcessorFixture;
+
+namespace
+{
+    // Hot enough to keep the limiter and soft clipper busy
+    const Settings renderSettings { .inputGainDb = 6.0, .delayMs = 45.0, .softClipEnabled = true };
+
+    // The noise either side of the gap of silence
+    constexpr int noiseSamples = 2 * (int) testSampleRate;
+
+    /** Noise loud enough to keep the limiter busy, with a gap of silence in the middle
+        so the processor also goes to sleep and wakes up again along the way. */
+    template <typename SampleType>
+    juce::AudioBuffer<SampleType> makeInput (int gapSamples)
+    {
+        juce::AudioBuffer<SampleType> input (2, 2 * noiseSamples + gapSamples);
+        juce::Random random (11);
+        fillWithNoise (input, random, 0.9f);
+
+        input.clear (noiseSamples, gapSamples);
+        return input;
+    }
+
+    /** Renders the input as planned and stitches the segments back together.
+        If given, slept is set when any segment's processor went to sleep. */
+    template <typename SampleType>
+    juce::AudioBuffer<SampleType> render (const juce::AudioBuffer<SampleType>& input, const std::vector<DSP::Core::RenderSegment>& segments,
+                                          bool* slept = nullptr)
+    {
+        juce::AudioBuffer<SampleType> output (2, input.getNumSamples());
+        juce::AudioBuffer<SampleType> buffer (2, testBlockSize);
+
+        for (const auto& segment : segments)
+        {
+            DSP::Core::ChasmDSPProcessor<SampleType> processor;
+            prepareProcessor (processor, renderSettings);
+
+            auto writePosition = segment.start;
+
+            auto read = [&] (juce::int64 position, juce::AudioBuffer<SampleType>& block)
+            {
+                block.clear();
+                const auto available = juce::jlimit<juce::int64> (0, block.getNumSamples(), input.getNumSamples() - position);
+
+                for (int channel = 0; channel < 2; ++channel)
+                    block.copyFrom (channel, 0, input, channel, (int) position, (int) available);
+
+                return true;
+            };
+
+            auto write = [&] (const juce::AudioBuffer<SampleType>& block, int startSample, int numSamples)
+            {
+                for (int channel = 0; channel < 2; ++channel)
+                    output.copyFrom (channel, (int) writePosition, block, channel, startSample, numSamples);
+
+                writePosition += numSamples;
+
+                if (slept != nullptr && processor.isSleeping())
+                    *slept = true;
+
+                return true;
+            };
+
+            REQUIRE (DSP::Core::renderSegment (processor, segment, buffer, read, write));
+            CHECK (writePosition == segment.end);
+        }
+
+        return output;
+    }
+
+    template <typename SampleType>
+    double maxDifference (const juce::AudioBuffer<SampleType>& a, const juce::AudioBuffer<SampleType>& b)
+    {
+        double difference = 0.0;
+
+        for (int channel = 0; channel < 2; ++channel)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                difference = std::max (difference, (double) std::abs (a.getSample (channel, i) - b.getSample (channel, i)));
+
+        return difference;
+    }
+}
+
+TEST_CASE ("Segment planning", "[offline]")
+{
+    const auto segments = DSP::Core::planSegments (100000, 4, 3000, testBlockSize);
+
+    REQUIRE (segments.size() == 4);
+    CHECK (segments.front().start == 0);
+    CHECK (segments.front().preRollStart == 0);
+    CHECK (segments.back().end == 100000);
+
+    for (size_t i = 1; i < segments.size(); ++i)
+    {
+        CHECK (segments[i].start == segments[i - 1].end);
+        CHECK (segments[i].start % testBlockSize == 0);
+        CHECK (segments[i].preRollStart % testBlockSize == 0);
+        CHECK (segments[i].start - segments[i].preRollStart >= 3000);
+    }
+
+    CHECK (DSP::Core::planSegments (1000, 8, 0, testBlockSize).size() == 2);
+    CHECK (DSP::Core::planSegments (0, 4, 0, testBlockSize).size() == 1);
+}
+
+TEMPLATE_TEST_CASE ("Segmented renders match a sequential render", "[offline]", float, double)
+{
+    DSP::Core::ChasmDSPProcessor<TestType> processor;
+    prepareProcessor (processor, renderSettings);
+
+    // Let the delay and character settle so the tail estimate is the one for these settings
+    juce::AudioBuffer<TestType> silence (2, testBlockSize);
+
+    for (int i = 0; i < (int) testSampleRate / testBlockSize; ++i)
+    {
+        silence.clear();
+        processor.processBlock (silence);
+    }
+
+    const auto preRoll = processor.getPreRollSamples();
+    const auto tailSamples = (int) std::ceil (processor.getTailLengthSeconds() * testSampleRate);
+
+    // The gap outlasts the tail and the latency, with a second to spare for the
+    // limiter's release, so the processor has to fall asleep in it
+    const auto input = makeInput<TestType> (tailSamples + processor.getLatencySamples() + (int) testSampleRate);
+
+    bool slept = false;
+    const auto sequential = render (input, DSP::Core::planSegments (input.getNumSamples(), 1, 0, testBlockSize), &slept);
+    REQUIRE (slept);
+
+    // Output that differs from the sequential render by less than this is below the processor's silence level
+    const auto tolerance = std::pow (10.0, DSP::Core::ChasmDSPProcessor<TestType>::silenceThresholdDb / 20.0);
+
+    SECTION ("with the processor's pre-roll")
+    {
+        const auto segments = DSP::Core::planSegments (input.getNumSamples(), 4, preRoll, testBlockSize);
+        REQUIRE (segments.size() == 4);
+
+        CHECK (maxDifference (render (input, segments), sequential) <= tolerance);
+    }
+
+    SECTION ("without pre-roll the seams are audible")
+    {
+        CHECK (maxDifference (render (input, DSP::Core::planSegments (input.getNumSamples(), 4, 0, testBlockSize)), sequential) > tolerance);
+    }
+}
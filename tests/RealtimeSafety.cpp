@@ -0,0 +1,168 @@
+#include "helpers/processor_fixture.h"
+#include "helpers/realtime_guard.h"
+#include <PluginProcessor.h>
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <mutex>
+
+using namespace ProcessorFixture;
+
+namespace
+{
+    void checkNoViolations()
+    {
+        for (const auto& violation : RealtimeGuard::takeViolations())
+            FAIL_CHECK (violation.description << "\n" << violation.stackTrace);
+    }
+
+    /** Moves every parameter to its own point on a sweep, the way host automation does
+        from outside the audio callback. */
+    void sweepParameters (PluginProcessor& plugin, float position)
+    {
+        const auto& parameters = plugin.getParameters();
+
+        for (int i = 0; i < parameters.size(); ++i)
+        {
+            auto* parameter = parameters.getUnchecked (i);
+
+            // Keep bypass off, it would skip the DSP under test
+            if (auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*> (parameter); withID != nullptr && withID->paramID == "BYPASS")
+                continue;
+
+            const auto value = std::fmod (position + 0.37f * static_cast<float> (i), 1.0f);
+            parameter->setValueNotifyingHost (value);
+        }
+    }
+
+    /** Drives processBlock through parameter sweeps, bypass, preset loads and changing
+        block sizes, running every callback inside a guard. */
+    template <typename SampleType>
+    void processGuarded (juce::AudioProcessor::ProcessingPrecision precision)
+    {
+        PluginProcessor plugin;
+        plugin.setProcessingPrecision (precision);
+        plugin.prepareToPlay (testSampleRate, testBlockSize);
+
+        // Two presets to switch between, captured before any audio runs
+        juce::MemoryBlock defaultPreset;
+        plugin.getStateInformation (defaultPreset);
+
+        sweepParameters (plugin, 0.9f);
+        juce::MemoryBlock sweptPreset;
+        plugin.getStateInformation (sweptPreset);
+
+        constexpr int maxBlockSize = 4096;
+        const std::array<int, 8> blockSizes { 1, 17, 64, 256, 480, testBlockSize, 1024, maxBlockSize };
+
+        juce::AudioBuffer<SampleType> storage (2, maxBlockSize);
+        juce::MidiBuffer midi;
+        juce::Random random (11);
+        auto* bypass = plugin.apvts.getParameter ("BYPASS");
+
+        for (int block = 0; block < 400; ++block)
+        {
+            // Everything the host does between callbacks happens unguarded
+            sweepParameters (plugin, static_cast<float> (block) / 400.0f);
+
+            if (block % 100 == 50)
+                plugin.setStateInformation (sweptPreset.getData(), static_cast<int> (sweptPreset.getSize()));
+            else if (block % 100 == 99)
+                plugin.setStateInformation (defaultPreset.getData(), static_cast<int> (defaultPreset.getSize()));
+
+            bypass->setValueNotifyingHost (block % 40 == 39 ? 1.0f : 0.0f);
+
+            const auto numSamples = blockSizes[static_cast<size_t> (block) % blockSizes.size()];
+
+            for (int channel = 0; channel < storage.getNumChannels(); ++channel)
+                for (int i = 0; i < numSamples; ++i)
+                    storage.setSample (channel, i, static_cast<SampleType> (random.nextFloat() - 0.5f));
+
+            juce::AudioBuffer<SampleType> buffer (storage.getArrayOfWritePointers(), storage.getNumChannels(), numSamples);
+
+            {
+                RealtimeGuard::ScopedGuard guard;
+                plugin.processBlock (buffer, midi);
+            }
+
+            checkNoViolations();
+        }
+
+        plugin.releaseResources();
+    }
+}
+
+TEST_CASE ("Real-time guard catches allocations and locks", "[realtime]")
+{
+    RealtimeGuard::takeViolations();
+
+    SECTION ("operator new and delete")
+    {
+        {
+            RealtimeGuard::ScopedGuard guard;
+            ::operator delete (::operator new (64));
+        }
+
+        CHECK (RealtimeGuard::takeViolations().size() == 2);
+    }
+
+    SECTION ("malloc and free")
+    {
+        if (RealtimeGuard::detectsMalloc())
+        {
+            {
+                RealtimeGuard::ScopedGuard guard;
+
+                // Volatile, so the compiler can't drop the unused allocation
+                void* volatile pointer = std::malloc (256);
+                std::free (pointer);
+            }
+
+            CHECK (RealtimeGuard::takeViolations().size() == 2);
+        }
+        else
+        {
+            WARN ("malloc is not intercepted on this platform");
+        }
+    }
+
+    SECTION ("mutex locks")
+    {
+        if (RealtimeGuard::detectsLocks())
+        {
+            std::mutex mutex;
+
+            {
+                RealtimeGuard::ScopedGuard guard;
+                const std::lock_guard<std::mutex> lock (mutex);
+            }
+
+            CHECK (RealtimeGuard::takeViolations().size() == 1);
+        }
+        else
+        {
+            WARN ("locks are not intercepted on this platform");
+        }
+    }
+
+    SECTION ("unguarded code is not checked")
+    {
+        ::operator delete (::operator new (64));
+    }
+
+    CHECK (RealtimeGuard::takeViolations().empty());
+}
+
+TEST_CASE ("processBlock is real-time safe", "[realtime]")
+{
+    SECTION ("Float")
+    {
+        processGuarded<float> (juce::AudioProcessor::singlePrecision);
+    }
+
+    SECTION ("Double")
+    {
+        processGuarded<double> (juce::AudioProcessor::doublePrecision);
+    }
+}
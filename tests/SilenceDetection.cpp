@@ -0,0 +1,81 @@
+#include "helpers/processor_fixture.h"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace ProcessorFixture;
+
+TEST_CASE ("Tail length follows the allpass settings", "[silence]")
+{
+    DSP::Core::ChasmDSPProcessor<float> processor;
+    prepareProcessor (processor, wetSettings);
+
+    juce::AudioBuffer<float> buffer (2, testBlockSize);
+
+    auto settle = [&] {
+        for (int block = 0; block < 200; ++block)
+        {
+            buffer.clear();
+            processor.processBlock (buffer);
+        }
+    };
+
+    processor.setDelay (30.0f);
+    processor.setCharacter (1.0f);
+    settle();
+    const auto shortTail = processor.getTailLengthSeconds();
+
+    processor.setCharacter (3.0f);
+    settle();
+    const auto longerTail = processor.getTailLengthSeconds();
+
+    processor.setDelay (100.0f);
+    settle();
+    const auto longestTail = processor.getTailLengthSeconds();
+
+    CHECK (shortTail > 0.0);
+    CHECK (longerTail > shortTail);
+    CHECK (longestTail > longerTail);
+}
+
+TEST_CASE ("Processor sleeps on silence and wakes on input", "[silence]")
+{
+    DSP::Core::ChasmDSPProcessor<float> processor;
+    prepareProcessor (processor, wetSettings);
+
+    juce::AudioBuffer<float> buffer (2, testBlockSize);
+    juce::Random random (1);
+
+    for (int block = 0; block < 20; ++block)
+    {
+        fillWithNoise (buffer, random);
+        processor.processBlock (buffer);
+    }
+
+    REQUIRE_FALSE (processor.isSleeping());
+
+    // The chain keeps ringing for the tail length, then goes to sleep
+    const auto tailBlocks = static_cast<int> (processor.getTailLengthSeconds() * testSampleRate / testBlockSize);
+    int silentBlocks = 0;
+
+    while (! processor.isSleeping() && silentBlocks < 10 * (tailBlocks + 10))
+    {
+        buffer.clear();
+        processor.processBlock (buffer);
+        ++silentBlocks;
+
+        if (silentBlocks == 1)
+            CHECK (buffer.getMagnitude (0, testBlockSize) > 0.0f);
+    }
+
+    CHECK (processor.isSleeping());
+    CHECK (silentBlocks >= tailBlocks);
+
+    buffer.clear();
+    processor.processBlock (buffer);
+    CHECK (buffer.getMagnitude (0, testBlockSize) == 0.0f);
+
+    // Any input wakes it up again
+    fillWithNoise (buffer, random);
+    processor.processBlock (buffer);
+    CHECK_FALSE (processor.isSleeping());
+    CHECK (buffer.getMagnitude (0, testBlockSize) > 0.0f);
+}
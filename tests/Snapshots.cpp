@@ -0,0 +1,89 @@
+#include "helpers/processor_fixture.h"
+#include "helpers/realtime_guard.h"
+#include <DSP/ChasmDSP.h>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+using namespace ProcessorFixture;
+
+namespace
+{
+    /** Renders numBlocks of noise, moving the delay every block so the snapshot also
+        has to capture ramps and smoothers mid-flight. */
+    template <typename SampleType>
+    std::vector<SampleType> render (DSP::Core::ChasmDSPProcessor<SampleType>& processor, juce::Random& random, int numBlocks)
+    {
+        juce::AudioBuffer<SampleType> buffer (2, testBlockSize);
+        std::vector<SampleType> output;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            fillWithNoise (buffer, random, 0.5f);
+            processor.setDelay (static_cast<SampleType> (20 + (block * 7) % 60));
+            processor.processBlock (buffer);
+
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < testBlockSize; ++i)
+                    output.push_back (buffer.getSample (channel, i));
+        }
+
+        return output;
+    }
+}
+
+TEMPLATE_TEST_CASE ("Snapshots restore the exact running state", "[snapshot]", float, double)
+{
+    DSP::Core::ChasmDSPProcessor<TestType> processor;
+    prepareProcessor (processor);
+
+    typename DSP::Core::ChasmDSPProcessor<TestType>::Snapshot snapshot;
+    processor.prepareSnapshot (snapshot);
+    CHECK_FALSE (snapshot.hasState());
+    CHECK_FALSE (processor.restoreSnapshot (snapshot));
+
+    juce::Random random (5);
+    render (processor, random, 40);
+
+    {
+        RealtimeGuard::ScopedGuard guard;
+        REQUIRE (processor.takeSnapshot (snapshot));
+    }
+
+    const auto seed = random.nextInt();
+
+    juce::Random first (seed);
+    const auto expected = render (processor, first, 20);
+
+    SECTION ("rolling back the same processor")
+    {
+        {
+            RealtimeGuard::ScopedGuard guard;
+            REQUIRE (processor.restoreSnapshot (snapshot));
+        }
+
+        juce::Random second (seed);
+        CHECK (render (processor, second, 20) == expected);
+    }
+
+    SECTION ("cloning into another processor")
+    {
+        DSP::Core::ChasmDSPProcessor<TestType> clone;
+        prepareProcessor (clone);
+        REQUIRE (clone.restoreSnapshot (snapshot));
+
+        juce::Random second (seed);
+        CHECK (render (clone, second, 20) == expected);
+    }
+
+    SECTION ("snapshots from other settings are refused")
+    {
+        DSP::Core::ChasmDSPProcessor<TestType> other;
+        other.prepare ({ 2.0 * testSampleRate, (juce::uint32) testBlockSize, 2 });
+        CHECK_FALSE (other.restoreSnapshot (snapshot));
+        CHECK_FALSE (other.takeSnapshot (snapshot));
+    }
+
+    for (const auto& violation : RealtimeGuard::takeViolations())
+        FAIL_CHECK (violation.description << "\n" << violation.stackTrace);
+}
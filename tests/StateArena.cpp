@@ -0,0 +1,112 @@
+#include <DSP/ChasmDSP.h>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <span>
+
+namespace
+{
+    bool isAligned (const void* pointer)
+    {
+        return reinterpret_cast<std::uintptr_t> (pointer) % DSP::Utils::StateArena::alignment == 0;
+    }
+
+    bool isInside (const DSP::Utils::StateArena& arena, const void* pointer)
+    {
+        const auto* byte = static_cast<const std::byte*> (pointer);
+        return byte >= arena.getData() && byte < arena.getData() + arena.getCapacity();
+    }
+}
+
+TEST_CASE ("State arena", "[arena]")
+{
+    DSP::Utils::StateArena arena;
+    std::span<float> first;
+    std::span<double> second;
+
+    auto allocateBoth = [&] (size_t numFirst, size_t numSecond)
+    {
+        arena.build ([&] (DSP::Utils::StateArena& builder)
+        {
+            first = builder.allocate<float> (numFirst);
+            second = builder.allocate<double> (numSecond);
+        });
+    };
+
+    allocateBoth (100, 10);
+
+    SECTION ("allocations are aligned, zeroed and carved from one block")
+    {
+        REQUIRE (first.size() == 100);
+        REQUIRE (second.size() == 10);
+
+        CHECK (isAligned (first.data()));
+        CHECK (isAligned (second.data()));
+        CHECK (isInside (arena, first.data()));
+        CHECK (isInside (arena, second.data()));
+
+        // 400 bytes round up to 448, and 80 to 128
+        CHECK (arena.getSize() == 576);
+        CHECK (arena.getCapacity() == arena.getSize());
+
+        for (auto value : first)
+            CHECK (value == 0.0f);
+
+        for (auto value : second)
+            CHECK (value == 0.0);
+    }
+
+    SECTION ("smaller builds reuse the block")
+    {
+        const auto* data = arena.getData();
+        first[0] = 1.0f;
+
+        allocateBoth (50, 10);
+
+        CHECK (arena.getData() == data);
+        CHECK (arena.getSize() < arena.getCapacity());
+        CHECK (isInside (arena, second.data()));
+        CHECK (first[0] == 0.0f);
+    }
+
+    SECTION ("larger builds grow the block")
+    {
+        allocateBoth (1000, 10);
+
+        CHECK (arena.getCapacity() == arena.getSize());
+        CHECK (isInside (arena, first.data()));
+        CHECK (isInside (arena, second.data() + second.size() - 1));
+    }
+}
+
+TEST_CASE ("Processor state lives in one arena", "[arena]")
+{
+    DSP::FloatProcessor processor;
+    processor.prepare ({ 48000.0, 512, 2 });
+
+    const auto& arena = processor.getStateArena();
+    const auto* data = arena.getData();
+    const auto size = arena.getSize();
+
+    // Four stereo delay lines sized for 41, 66, 97 and 100 ms at 48 kHz, rounded to powers of two
+    constexpr size_t delayLineBytes = (2048 + 4096 + 8192 + 8192) * 2 * sizeof (float);
+    CHECK (size > delayLineBytes);
+
+    // Less than the delay lines alone took when every stage reserved the full 100 ms
+    CHECK (size < 4 * 8192 * 2 * sizeof (float));
+
+    SECTION ("preparing again at the same or a lower rate does not reallocate")
+    {
+        processor.prepare ({ 48000.0, 512, 2 });
+        CHECK (arena.getData() == data);
+        CHECK (arena.getSize() == size);
+
+        processor.prepare ({ 44100.0, 1024, 2 });
+        CHECK (arena.getData() == data);
+    }
+
+    SECTION ("a higher rate grows the arena")
+    {
+        processor.prepare ({ 96000.0, 512, 2 });
+        CHECK (arena.getSize() > size);
+    }
+}
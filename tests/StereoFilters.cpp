@@ -0,0 +1,204 @@
+#include <DSP/Filters/EQFilters.h>
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+namespace
+{
+    constexpr double testSampleRate = 48000.0;
+    constexpr int impulseLength = 8192;
+
+    // Largest deviation in dB from the exact response that interpolating between table entries may cause
+    constexpr double tableTolerance = 0.05;
+
+    // Settings that fall between the entries of the coefficient tables
+    constexpr std::array<double, 3> brightnessSettings { -7.3, 3.1, 11.9 };
+    constexpr std::array<double, 3> cutSettings { 12.3, 47.7, 88.8 };
+
+    /** Runs frames with signal in one channel only through a stereo filter and
+        returns both channels. */
+    template <typename SampleType, typename Filter>
+    std::array<std::vector<SampleType>, 2> processOneChannel (Filter& filter, size_t activeChannel)
+    {
+        constexpr int numFrames = 4096;
+        std::vector<SampleType> frames (numFrames * 2, SampleType (0));
+        juce::Random random (3);
+
+        for (int i = 0; i < numFrames; ++i)
+            frames[static_cast<size_t> (i) * 2 + activeChannel] = static_cast<SampleType> (random.nextFloat() * 2.0f - 1.0f);
+
+        // Odd block lengths so both channels cross block boundaries at odd offsets
+        for (int start = 0; start < numFrames; start += 77)
+            filter.processFrames (frames.data() + start * 2, std::min (77, numFrames - start));
+
+        std::array<std::vector<SampleType>, 2> channels;
+
+        for (int i = 0; i < numFrames; ++i)
+            for (size_t channel = 0; channel < 2; ++channel)
+                channels[channel].push_back (frames[static_cast<size_t> (i) * 2 + channel]);
+
+        return channels;
+    }
+
+    template <typename SampleType>
+    bool isSilent (const std::vector<SampleType>& samples)
+    {
+        return std::all_of (samples.begin(), samples.end(), [] (SampleType sample) { return sample == SampleType (0); });
+    }
+
+    /** Returns the impulse response of the left channel of a stereo filter. */
+    template <typename SampleType, typename Filter>
+    std::vector<double> getImpulseResponse (Filter& filter)
+    {
+        std::vector<double> response;
+
+        for (int i = 0; i < impulseLength; ++i)
+        {
+            std::array<SampleType, 2> frame { SampleType (i == 0 ? 1 : 0), SampleType (0) };
+            filter.processFrames (frame.data(), 1);
+            response.push_back (static_cast<double> (frame[0]));
+        }
+
+        return response;
+    }
+
+    /** Returns the impulse response of a JUCE filter with the given coefficients. */
+    template <typename SampleType>
+    std::vector<double> getImpulseResponse (typename juce::dsp::IIR::Coefficients<SampleType>::Ptr coefficients)
+    {
+        juce::dsp::IIR::Filter<SampleType> filter;
+        filter.coefficients = coefficients;
+        filter.reset();
+
+        std::vector<double> response;
+
+        for (int i = 0; i < impulseLength; ++i)
+            response.push_back (static_cast<double> (filter.processSample (SampleType (i == 0 ? 1 : 0))));
+
+        return response;
+    }
+
+    double getMagnitudeDb (const std::vector<double>& impulseResponse, double frequency)
+    {
+        std::complex<double> sum;
+
+        for (size_t i = 0; i < impulseResponse.size(); ++i)
+            sum += impulseResponse[i] * std::polar (1.0, -juce::MathConstants<double>::twoPi * frequency * static_cast<double> (i) / testSampleRate);
+
+        return 20.0 * std::log10 (std::max (std::abs (sum), 1.0e-12));
+    }
+
+    /** Compares two responses in dB wherever the reference is above -40 dB. */
+    void checkResponsesMatch (const std::vector<double>& response, const std::vector<double>& reference)
+    {
+        for (double frequency : { 30.0, 100.0, 300.0, 1000.0, 3000.0, 8000.0, 15000.0 })
+        {
+            const auto referenceDb = getMagnitudeDb (reference, frequency);
+
+            if (referenceDb > -40.0)
+                CHECK (std::abs (getMagnitudeDb (response, frequency) - referenceDb) < tableTolerance);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE ("Stereo EQ and cut filters keep the channels independent", "[filters]", float, double)
+{
+    const juce::dsp::ProcessSpec spec { testSampleRate, 512, 2 };
+
+    for (size_t activeChannel : { size_t (0), size_t (1) })
+    {
+        DSP::Filters::BrightnessEQ<TestType, 2> brightnessEQ;
+        brightnessEQ.prepare (spec);
+        brightnessEQ.setBrightness (TestType (6));
+
+        const auto eqOutput = processOneChannel<TestType> (brightnessEQ, activeChannel);
+        CHECK (isSilent (eqOutput[1 - activeChannel]));
+        CHECK (! isSilent (eqOutput[activeChannel]));
+
+        DSP::Filters::DualCutFilter<TestType, 2> dualCutFilter;
+        dualCutFilter.prepare (spec);
+        dualCutFilter.setLowCut (TestType (30));
+        dualCutFilter.setHighCut (TestType (60));
+
+        const auto cutOutput = processOneChannel<TestType> (dualCutFilter, activeChannel);
+        CHECK (isSilent (cutOutput[1 - activeChannel]));
+        CHECK (! isSilent (cutOutput[activeChannel]));
+    }
+}
+
+TEMPLATE_TEST_CASE ("Tabulated filters match the JUCE reference coefficients", "[filters]", float, double)
+{
+    using Coefficients = juce::dsp::IIR::Coefficients<TestType>;
+    const juce::dsp::ProcessSpec spec { testSampleRate, 512, 2 };
+
+    SECTION ("Brightness")
+    {
+        for (auto brightnessDb : brightnessSettings)
+        {
+            DSP::Filters::BrightnessEQ<TestType, 2> brightnessEQ;
+            brightnessEQ.prepare (spec);
+            brightnessEQ.setBrightness (static_cast<TestType> (brightnessDb));
+
+            const auto reference = Coefficients::makeHighShelf (testSampleRate, TestType (3000), TestType (0.707),
+                                                                juce::Decibels::decibelsToGain (static_cast<TestType> (brightnessDb)));
+
+            checkResponsesMatch (getImpulseResponse<TestType> (brightnessEQ), getImpulseResponse<TestType> (reference));
+        }
+    }
+
+    SECTION ("Low cut")
+    {
+        for (auto cutAmount : cutSettings)
+        {
+            DSP::Filters::DualCutFilter<TestType, 2> dualCutFilter;
+            dualCutFilter.prepare (spec);
+            dualCutFilter.setLowCut (static_cast<TestType> (cutAmount));
+
+            const auto frequency = TestType (20) + static_cast<TestType> (cutAmount) * TestType (0.01) * TestType (980);
+            const auto reference = Coefficients::makeHighPass (testSampleRate, frequency, TestType (0.707));
+
+            checkResponsesMatch (getImpulseResponse<TestType> (dualCutFilter), getImpulseResponse<TestType> (reference));
+        }
+    }
+
+    SECTION ("High cut")
+    {
+        for (auto cutAmount : cutSettings)
+        {
+            DSP::Filters::DualCutFilter<TestType, 2> dualCutFilter;
+            dualCutFilter.prepare (spec);
+            dualCutFilter.setHighCut (static_cast<TestType> (cutAmount));
+
+            const auto frequency = TestType (20000) - static_cast<TestType> (cutAmount) * TestType (0.01) * TestType (19000);
+            const auto reference = Coefficients::makeLowPass (testSampleRate, frequency, TestType (0.707));
+
+            checkResponsesMatch (getImpulseResponse<TestType> (dualCutFilter), getImpulseResponse<TestType> (reference));
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE ("Cut filters stay stable below 40 kHz", "[filters]", float, double)
+{
+    // The high cut's 20 kHz end is above Nyquist at these rates
+    for (double sampleRate : { 22050.0, 32000.0 })
+    {
+        DSP::Filters::DualCutFilter<TestType, 2> dualCutFilter;
+        dualCutFilter.prepare ({ sampleRate, 512, 2 });
+
+        for (auto cutAmount : { 0.0, 5.0, 50.0 })
+        {
+            dualCutFilter.reset();
+            dualCutFilter.setLowCut (static_cast<TestType> (cutAmount));
+            dualCutFilter.setHighCut (static_cast<TestType> (cutAmount));
+
+            const auto response = getImpulseResponse<TestType> (dualCutFilter);
+
+            CHECK (std::all_of (response.begin(), response.end(), [] (double sample) { return std::isfinite (sample); }));
+            CHECK (std::abs (response.back()) < 1.0e-6);
+        }
+    }
+}
@@ -0,0 +1,297 @@
+#include "realtime_guard.h"
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <utility>
+
+// Replacing malloc needs glibc's internal entry points, and clashes with sanitizers
+#if defined(__GLIBC__) && ! defined(__SANITIZE_ADDRESS__) && ! defined(__SANITIZE_THREAD__)
+    #define CHASM_GUARD_MALLOC 1
+    #include <cerrno>
+    #include <dlfcn.h>
+    #include <pthread.h>
+
+extern "C"
+{
+    void* __libc_malloc (size_t);
+    void* __libc_calloc (size_t, size_t);
+    void* __libc_realloc (void*, size_t);
+    void* __libc_memalign (size_t, size_t);
+    void __libc_free (void*);
+}
+#else
+    #define CHASM_GUARD_MALLOC 0
+
+    #if defined(_MSC_VER)
+        #include <malloc.h>
+    #endif
+#endif
+
+namespace
+{
+    // Only touched by their own thread, and trivially constructible, so they are safe to
+    // use from inside malloc
+    thread_local int guardDepth = 0;
+    thread_local bool reporting = false;
+
+    std::mutex violationsLock;
+
+    std::vector<RealtimeGuard::Violation>& getViolations()
+    {
+        static std::vector<RealtimeGuard::Violation> violations;
+        return violations;
+    }
+
+    void record (const char* function, size_t numBytes)
+    {
+        auto description = juce::String (function) + " on a guarded thread";
+
+        if (numBytes > 0)
+            description << " (" << (juce::int64) numBytes << " bytes)";
+
+        const std::lock_guard<std::mutex> lock (violationsLock);
+        getViolations().push_back ({ description, juce::SystemStats::getStackBacktrace() });
+    }
+
+    void report (const char* function, size_t numBytes = 0)
+    {
+        if (guardDepth == 0 || reporting)
+            return;
+
+        // Recording allocates and locks too, including when its locals are destroyed,
+        // so the flag stays set until record() has returned
+        reporting = true;
+        record (function, numBytes);
+        reporting = false;
+    }
+
+    void* allocate (size_t numBytes)
+    {
+       #if CHASM_GUARD_MALLOC
+        return __libc_malloc (numBytes == 0 ? 1 : numBytes);
+       #else
+        return std::malloc (numBytes == 0 ? 1 : numBytes);
+       #endif
+    }
+
+    void* allocateAligned (size_t numBytes, std::align_val_t alignment)
+    {
+        const auto align = static_cast<size_t> (alignment);
+
+       #if CHASM_GUARD_MALLOC
+        return __libc_memalign (align, numBytes == 0 ? 1 : numBytes);
+       #elif defined(_MSC_VER)
+        return _aligned_malloc (numBytes == 0 ? 1 : numBytes, align);
+       #else
+        return std::aligned_alloc (align, (numBytes + align - 1) / align * align);
+       #endif
+    }
+
+    void deallocate (void* pointer)
+    {
+       #if CHASM_GUARD_MALLOC
+        __libc_free (pointer);
+       #else
+        std::free (pointer);
+       #endif
+    }
+
+    void deallocateAligned (void* pointer)
+    {
+       #if defined(_MSC_VER) && ! CHASM_GUARD_MALLOC
+        _aligned_free (pointer);
+       #else
+        deallocate (pointer);
+       #endif
+    }
+}
+
+namespace RealtimeGuard
+{
+    ScopedGuard::ScopedGuard()
+    {
+        ++guardDepth;
+    }
+
+    ScopedGuard::~ScopedGuard()
+    {
+        --guardDepth;
+    }
+
+    std::vector<Violation> takeViolations()
+    {
+        const std::lock_guard<std::mutex> lock (violationsLock);
+        return std::exchange (getViolations(), {});
+    }
+
+    bool detectsMalloc()
+    {
+        return CHASM_GUARD_MALLOC != 0;
+    }
+
+    bool detectsLocks()
+    {
+        return CHASM_GUARD_MALLOC != 0;
+    }
+}
+
+//==============================================================================
+// Global operator new and delete, on every platform
+
+void* operator new (std::size_t numBytes)
+{
+    report ("operator new", numBytes);
+
+    if (auto* pointer = allocate (numBytes))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t numBytes)
+{
+    return operator new (numBytes);
+}
+
+void* operator new (std::size_t numBytes, const std::nothrow_t&) noexcept
+{
+    report ("operator new", numBytes);
+    return allocate (numBytes);
+}
+
+void* operator new[] (std::size_t numBytes, const std::nothrow_t& tag) noexcept
+{
+    return operator new (numBytes, tag);
+}
+
+void* operator new (std::size_t numBytes, std::align_val_t alignment)
+{
+    report ("operator new", numBytes);
+
+    if (auto* pointer = allocateAligned (numBytes, alignment))
+        return pointer;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[] (std::size_t numBytes, std::align_val_t alignment)
+{
+    return operator new (numBytes, alignment);
+}
+
+void* operator new (std::size_t numBytes, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    report ("operator new", numBytes);
+    return allocateAligned (numBytes, alignment);
+}
+
+void* operator new[] (std::size_t numBytes, std::align_val_t alignment, const std::nothrow_t& tag) noexcept
+{
+    return operator new (numBytes, alignment, tag);
+}
+
+void operator delete (void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        report ("operator delete");
+
+    deallocate (pointer);
+}
+
+void operator delete[] (void* pointer) noexcept { operator delete (pointer); }
+void operator delete (void* pointer, std::size_t) noexcept { operator delete (pointer); }
+void operator delete[] (void* pointer, std::size_t) noexcept { operator delete (pointer); }
+void operator delete (void* pointer, const std::nothrow_t&) noexcept { operator delete (pointer); }
+void operator delete[] (void* pointer, const std::nothrow_t&) noexcept { operator delete (pointer); }
+
+void operator delete (void* pointer, std::align_val_t) noexcept
+{
+    if (pointer != nullptr)
+        report ("operator delete");
+
+    deallocateAligned (pointer);
+}
+
+void operator delete[] (void* pointer, std::align_val_t alignment) noexcept { operator delete (pointer, alignment); }
+void operator delete (void* pointer, std::size_t, std::align_val_t alignment) noexcept { operator delete (pointer, alignment); }
+void operator delete[] (void* pointer, std::size_t, std::align_val_t alignment) noexcept { operator delete (pointer, alignment); }
+void operator delete (void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept { operator delete (pointer, alignment); }
+void operator delete[] (void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept { operator delete (pointer, alignment); }
+
+//==============================================================================
+// The C allocator and pthread mutexes, where the platform lets us replace them
+
+#if CHASM_GUARD_MALLOC
+extern "C"
+{
+    void* malloc (size_t numBytes)
+    {
+        report ("malloc", numBytes);
+        return __libc_malloc (numBytes);
+    }
+
+    void* calloc (size_t numElements, size_t elementSize)
+    {
+        report ("calloc", numElements * elementSize);
+        return __libc_calloc (numElements, elementSize);
+    }
+
+    void* realloc (void* pointer, size_t numBytes)
+    {
+        report ("realloc", numBytes);
+        return __libc_realloc (pointer, numBytes);
+    }
+
+    void free (void* pointer)
+    {
+        if (pointer != nullptr)
+            report ("free");
+
+        __libc_free (pointer);
+    }
+
+    void* memalign (size_t alignment, size_t numBytes)
+    {
+        report ("memalign", numBytes);
+        return __libc_memalign (alignment, numBytes);
+    }
+
+    void* aligned_alloc (size_t alignment, size_t numBytes)
+    {
+        report ("aligned_alloc", numBytes);
+        return __libc_memalign (alignment, numBytes);
+    }
+
+    int posix_memalign (void** result, size_t alignment, size_t numBytes)
+    {
+        report ("posix_memalign", numBytes);
+
+        auto* pointer = __libc_memalign (alignment, numBytes);
+
+        if (pointer == nullptr)
+            return ENOMEM;
+
+        *result = pointer;
+        return 0;
+    }
+
+    int pthread_mutex_lock (pthread_mutex_t* mutex)
+    {
+        using LockFunction = int (*) (pthread_mutex_t*);
+
+        // Looked up without a function-local static, whose guard could lock a mutex itself
+        static std::atomic<LockFunction> realLock { nullptr };
+        auto lock = realLock.load (std::memory_order_relaxed);
+
+        if (lock == nullptr)
+        {
+            lock = reinterpret_cast<LockFunction> (dlsym (RTLD_NEXT, "pthread_mutex_lock"));
+            realLock.store (lock, std::memory_order_relaxed);
+        }
+
+        report ("pthread_mutex_lock");
+        return lock (mutex);
+    }
+}
+#endif
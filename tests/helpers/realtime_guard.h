@@ -0,0 +1,51 @@
+#pragma once
+#include <juce_core/juce_core.h>
+#include <vector>
+
+/* Catches real-time safety violations in tests: heap allocations, frees and mutex
+ * locks made by a thread while it holds a RealtimeGuard::ScopedGuard.
+ *
+ * The Tests target replaces the global operator new and delete, so C++ allocations
+ * are caught everywhere. On glibc malloc, calloc, realloc, free and
+ * pthread_mutex_lock are replaced as well, which also catches juce::HeapBlock,
+ * AudioBuffer::setSize and juce::CriticalSection / std::mutex locks. Each violation
+ * keeps the stack trace it happened at.
+ *
+ * Example usage
+ *
+  {
+    RealtimeGuard::ScopedGuard guard;
+    plugin.processBlock (buffer, midi);
+  }
+
+  for (auto& violation : RealtimeGuard::takeViolations())
+    FAIL_CHECK (violation.description << "\n" << violation.stackTrace);
+
+ */
+namespace RealtimeGuard
+{
+    struct Violation
+    {
+        juce::String description;
+        juce::String stackTrace;
+    };
+
+    /** Checks the calling thread for as long as it exists. Guards may be nested. */
+    class ScopedGuard
+    {
+    public:
+        ScopedGuard();
+        ~ScopedGuard();
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedGuard)
+    };
+
+    /** Returns the violations recorded so far, on any thread, and forgets them. */
+    std::vector<Violation> takeViolations();
+
+    /** True if malloc and free are checked too, not just operator new and delete. */
+    bool detectsMalloc();
+
+    /** True if mutex locks are checked on this platform. */
+    bool detectsLocks();
+}